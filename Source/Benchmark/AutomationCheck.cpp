@@ -0,0 +1,132 @@
+/*
+ ==============================================================================
+ 
+ AutomationCheck.cpp
+ Created: 17 Oct 2026 2:18:44pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "AutomationCheck.h"
+#include <limits>
+
+namespace
+{
+void setParameter(SimpleMBCompAudioProcessor& processor, Params::Names name, float value)
+{
+    auto* parameter = processor.apvts.getParameter(Params::GetParams().at(name));
+    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+}
+
+//==============================================================================
+AutomationCheck::AutomationCheck(const AutomationCheckSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+juce::Array<AutomationCheck::Change> AutomationCheck::getChanges()
+{
+    using namespace Params;
+    
+    return
+    {
+        { "threshold", Names::Threshold_Band, -40.f },
+        { "knee",      Names::Knee_Band,      12.f },
+        { "attack",    Names::Attack_Band,    5.f },
+        { "release",   Names::Release_Band,   50.f },
+        { "crossover", Names::Crossover_Freq, getCrossoverDefault(0) * 1.5f },
+    };
+}
+
+juce::Array<AutomationCheckResult> AutomationCheck::run(const BenchmarkConfig& config)
+{
+    auto length = static_cast<int>(settings.seconds * config.sampleRate);
+    juce::AudioBuffer<float> input(config.numChannels, length);
+    fillWithNoise(input);
+    
+    auto compareStart = length - static_cast<int>(settings.compareSeconds * config.sampleRate);
+    juce::Array<AutomationCheckResult> results;
+    
+    for( auto hostBlockSize : settings.hostBlockSizes )
+    {
+        auto hostConfig = config;
+        hostConfig.blockSize = hostBlockSize;
+        
+        for( const auto& change : getChanges() )
+        {
+            auto expected = render(hostConfig, change, true,  input);
+            auto actual =   render(hostConfig, change, false, input);
+            
+            AutomationCheckResult result;
+            result.name = hostConfig.getName("automation") + "/" + change.name;
+            
+            for( int channel = 0; channel < config.numChannels; ++channel )
+            {
+                auto* expectedSamples = expected.getReadPointer(channel);
+                auto* actualSamples =   actual.getReadPointer(channel);
+                
+                for( int i = compareStart; i < length; ++i )
+                {
+                    // a NaN never compares, and fails the check outright
+                    auto difference = std::abs(actualSamples[i] - expectedSamples[i]);
+                    result.maxDifference = std::isnan(difference) ? std::numeric_limits<float>::infinity()
+                                                                  : juce::jmax(result.maxDifference, difference);
+                }
+            }
+            
+            results.add(result);
+        }
+    }
+    
+    return results;
+}
+
+juce::AudioBuffer<float> AutomationCheck::render(const BenchmarkConfig& config,
+                                                 const Change& change,
+                                                 bool changeFromStart,
+                                                 const juce::AudioBuffer<float>& input)
+{
+    juce::AudioBuffer<float> output(input);
+    
+    SimpleMBCompAudioProcessor processor;
+    if( ! prepareProcessor(processor, config, {}) )
+    {
+        jassertfalse;
+        return output;
+    }
+    
+    for( size_t band = 0; band < Params::NumBands; ++band )
+        setParameter(processor, Params::forBand(Params::Names::Threshold_Band, band), AutomationCheckSettings::baseThresholdDb);
+    
+    if( changeFromStart )
+        setParameter(processor, change.parameter, change.value);
+    
+    // everything set so far is where the render starts from
+    processor.prepareToPlay(config.sampleRate, config.blockSize);
+    processor.reset();
+    
+    auto changeSample = static_cast<int>(settings.changeSeconds * config.sampleRate);
+    auto changed = changeFromStart;
+    juce::MidiBuffer midi;
+    
+    for( int start = 0; start < output.getNumSamples(); start += config.blockSize )
+    {
+        // the host hands the new value over with the block it applies to
+        if( ! changed && start >= changeSample )
+        {
+            setParameter(processor, change.parameter, change.value);
+            changed = true;
+        }
+        
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(),
+                                       output.getNumChannels(),
+                                       start,
+                                       juce::jmin(config.blockSize, output.getNumSamples() - start));
+        processor.processBlock(block, midi);
+        processor.updateMeterHistory();
+    }
+    
+    return output;
+}
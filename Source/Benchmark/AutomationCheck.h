@@ -0,0 +1,74 @@
+/*
+ ==============================================================================
+ 
+ AutomationCheck.h
+ Created: 17 Oct 2026 2:18:44pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorBenchmark.h"
+
+//==============================================================================
+struct AutomationCheckSettings
+{
+    double seconds { 4.0 };         // of seeded noise per render
+    double changeSeconds { 0.25 };  // when the parameter moves
+    double compareSeconds { 1.0 };  // at the end of the render
+    juce::Array<int> hostBlockSizes { 32, 64, 512 };
+    
+    // every band compresses the noise, so a threshold or knee that's off shows
+    static constexpr float baseThresholdDb = -24.f;
+    
+    // what's left of the envelopes from before the change has long decayed
+    static constexpr float tolerance = 1.0e-4f;    // -80 dBFS
+};
+
+struct AutomationCheckResult
+{
+    juce::String name;
+    float maxDifference { 0.f };
+    
+    bool passed() const { return maxDifference <= AutomationCheckSettings::tolerance; }
+};
+
+//==============================================================================
+/*
+ Checks that a parameter change from the host ends up fully applied, however
+ the host's blocks line up with the processor's sub-blocks.
+ 
+ For each of a threshold, knee, attack, release and crossover frequency, and
+ each of hostBlockSizes, one processor renders seeded noise with the
+ parameter at its new value from the start, and another one with the
+ parameter changed changeSeconds in, as a host would automate it. Once both
+ have had time to settle, the last compareSeconds of the two renders have to
+ match.
+ */
+struct AutomationCheck
+{
+    explicit AutomationCheck(const AutomationCheckSettings& settingsToUse);
+    
+    juce::Array<AutomationCheckResult> run(const BenchmarkConfig& config);
+private:
+    AutomationCheckSettings settings;
+    
+    struct Change
+    {
+        juce::String name;
+        Params::Names parameter;
+        float value;
+    };
+    
+    static juce::Array<Change> getChanges();
+    
+    juce::AudioBuffer<float> render(const BenchmarkConfig& config,
+                                    const Change& change,
+                                    bool changeFromStart,
+                                    const juce::AudioBuffer<float>& input);
+    
+    JUCE_DECLARE_NON_COPYABLE(AutomationCheck)
+};
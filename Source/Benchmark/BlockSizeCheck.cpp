@@ -0,0 +1,114 @@
+/*
+ ==============================================================================
+ 
+ BlockSizeCheck.cpp
+ Created: 14 Oct 2026 9:47:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "BlockSizeCheck.h"
+#include <limits>
+
+namespace
+{
+constexpr juce::int64 noiseSeed = 0x5eed;
+}
+
+//==============================================================================
+BlockSizeCheck::BlockSizeCheck(const BlockSizeCheckSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+juce::Array<BlockSizeCheckResult> BlockSizeCheck::run(const BenchmarkConfig& config, bool linearPhase)
+{
+    auto length = static_cast<int>(settings.seconds * config.sampleRate);
+    juce::AudioBuffer<float> input(config.numChannels, length);
+    juce::Random random(noiseSeed);
+    
+    for( int channel = 0; channel < config.numChannels; ++channel )
+    {
+        auto* samples = input.getWritePointer(channel);
+        for( int i = 0; i < length; ++i )
+        {
+            samples[i] = random.nextFloat() - 0.5f;
+        }
+    }
+    
+    auto reference = render(config, linearPhase, input, config.blockSize);
+    juce::Array<BlockSizeCheckResult> results;
+    
+    for( auto hostBlockSize : settings.hostBlockSizes )
+    {
+        auto output = render(config, linearPhase, input, hostBlockSize);
+        
+        BlockSizeCheckResult result;
+        result.hostBlockSize = hostBlockSize;
+        
+        for( int channel = 0; channel < config.numChannels; ++channel )
+        {
+            auto* expected = reference.getReadPointer(channel);
+            auto* actual = output.getReadPointer(channel);
+            
+            if( output.getMagnitude(channel, length / 2, length - length / 2) <= BlockSizeCheckSettings::tolerance )
+                ++result.numSilentChannels;
+            
+            for( int i = 0; i < length; ++i )
+            {
+                if( actual[i] == expected[i] )
+                    continue;
+                
+                // a NaN never compares equal, and fails the check outright
+                auto difference = std::abs(actual[i] - expected[i]);
+                
+                ++result.numDifferentSamples;
+                result.maxDifference = std::isnan(difference) ? std::numeric_limits<float>::infinity()
+                                                              : juce::jmax(result.maxDifference, difference);
+            }
+        }
+        
+        results.add(result);
+    }
+    
+    return results;
+}
+
+juce::AudioBuffer<float> BlockSizeCheck::render(const BenchmarkConfig& config,
+                                                bool linearPhase,
+                                                const juce::AudioBuffer<float>& input,
+                                                int hostBlockSize)
+{
+    juce::AudioBuffer<float> output(input);
+    
+    SimpleMBCompAudioProcessor processor;
+    if( ! prepareProcessor(processor, config, settings.preset) )
+    {
+        jassertfalse;
+        return output;
+    }
+    
+    if( linearPhase )
+    {
+        auto* mode = processor.apvts.getParameter(Params::GetParams().at(Params::Names::Crossover_Mode));
+        mode->setValueNotifyingHost(mode->convertTo0to1(static_cast<float>(Params::CrossoverMode::LinearPhase)));
+        
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+        processor.reset();
+    }
+    
+    juce::MidiBuffer midi;
+    
+    for( int start = 0; start < output.getNumSamples(); start += hostBlockSize )
+    {
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(),
+                                       output.getNumChannels(),
+                                       start,
+                                       juce::jmin(hostBlockSize, output.getNumSamples() - start));
+        processor.processBlock(block, midi);
+        processor.updateMeterHistory();
+    }
+    
+    return output;
+}
@@ -0,0 +1,62 @@
+/*
+ ==============================================================================
+ 
+ BlockSizeCheck.h
+ Created: 14 Oct 2026 9:47:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorBenchmark.h"
+
+//==============================================================================
+struct BlockSizeCheckSettings
+{
+    juce::MemoryBlock preset;   // processor state, empty for the defaults
+    double seconds { 2.0 };     // of seeded noise per render
+    juce::Array<int> hostBlockSizes { 1, 17, 63, 64, 65, 100, 256, 1000, 4096 };
+    
+    // float rounding may differ where a host block splits a sub-block
+    static constexpr float tolerance = 1.0e-6f;    // -120 dBFS
+};
+
+struct BlockSizeCheckResult
+{
+    int hostBlockSize { 0 };
+    float maxDifference { 0.f };
+    juce::int64 numDifferentSamples { 0 };
+    int numSilentChannels { 0 };
+    
+    bool passed() const { return maxDifference <= BlockSizeCheckSettings::tolerance && numSilentChannels == 0; }
+};
+
+//==============================================================================
+/*
+ Renders the same noise once with host blocks of config.blockSize, the size
+ the processor is prepared for, and again for every one of hostBlockSizes,
+ and compares the outputs sample by sample. The parameters stay put, so
+ any difference comes from where the host's blocks happen to end.
+ 
+ Every channel gets noise, so an output channel that stays silent over the
+ second half of the render was never processed, e.g. by a stage that only
+ handles the first two channels.
+ */
+struct BlockSizeCheck
+{
+    explicit BlockSizeCheck(const BlockSizeCheckSettings& settingsToUse);
+    
+    juce::Array<BlockSizeCheckResult> run(const BenchmarkConfig& config, bool linearPhase);
+private:
+    BlockSizeCheckSettings settings;
+    
+    juce::AudioBuffer<float> render(const BenchmarkConfig& config,
+                                    bool linearPhase,
+                                    const juce::AudioBuffer<float>& input,
+                                    int hostBlockSize);
+    
+    JUCE_DECLARE_NON_COPYABLE(BlockSizeCheck)
+};
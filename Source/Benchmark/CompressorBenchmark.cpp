@@ -0,0 +1,128 @@
+/*
+ ==============================================================================
+ 
+ CompressorBenchmark.cpp
+ Created: 17 Oct 2026 10:31:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "CompressorBenchmark.h"
+#include <type_traits>
+
+namespace
+{
+// many times the attack, so every level of the sweep has settled
+constexpr double settleSeconds = 0.25;
+}
+
+//==============================================================================
+CompressorBenchmark::CompressorBenchmark(const BenchmarkSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+CompressorComparison CompressorBenchmark::run(const BenchmarkConfig& config)
+{
+    CompressorComparison comparison;
+    comparison.fast.config = config;
+    comparison.classic.config = config;
+    
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = config.sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(config.blockSize);
+    spec.numChannels = static_cast<juce::uint32>(config.numChannels);
+    
+    FastCompressor<float> fast;
+    juce::dsp::Compressor<float> classic;
+    setUp(fast, spec);
+    setUp(classic, spec);
+    
+    // the sweep goes up, so each level is reached through the attack
+    juce::AudioBuffer<float> block(config.numChannels, config.blockSize);
+    auto settleSamples = static_cast<int>(settleSeconds * config.sampleRate);
+    
+    for( auto levelDb = sweepLowDb; levelDb <= sweepHighDb; levelDb += sweepStepDb )
+    {
+        auto fastGainDb =    getStaticGainDb(fast,    block, levelDb, settleSamples);
+        auto classicGainDb = getStaticGainDb(classic, block, levelDb, settleSamples);
+        
+        comparison.maxCurveErrorDb = juce::jmax(comparison.maxCurveErrorDb, std::abs(fastGainDb - classicGainDb));
+    }
+    
+    fast.reset();
+    classic.reset();
+    
+    // a second of noise, read round and round
+    auto noiseLength = juce::jmax(config.blockSize * 2, static_cast<int>(config.sampleRate));
+    juce::AudioBuffer<float> noise(config.numChannels, noiseLength);
+    fillWithNoise(noise);
+    
+    auto warmupBlocks = static_cast<int>(settings.warmupSeconds * config.sampleRate) / config.blockSize;
+    
+    auto time = [&](auto& compressor)
+    {
+        return timeBlocks(settings, warmupBlocks, [&, position = 0]() mutable
+        {
+            if( position + config.blockSize > noiseLength )
+                position = 0;
+            
+            for( int channel = 0; channel < config.numChannels; ++channel )
+                block.copyFrom(channel, 0, noise, channel, position, config.blockSize);
+            
+            position += config.blockSize;
+            
+            auto audioBlock = juce::dsp::AudioBlock<float>(block);
+            auto context = juce::dsp::ProcessContextReplacing<float>(audioBlock);
+            
+            auto start = juce::Time::getHighResolutionTicks();
+            compressor.process(context);
+            return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+        });
+    };
+    
+    auto fastTimes =    time(fast);
+    auto classicTimes = time(classic);
+    
+    comparison.fast.iterations =    static_cast<int>(fastTimes.size());
+    comparison.fast.total =         Distribution::fromSamples(fastTimes);
+    comparison.classic.iterations = static_cast<int>(classicTimes.size());
+    comparison.classic.total =      Distribution::fromSamples(classicTimes);
+    
+    return comparison;
+}
+
+template<typename Compressor>
+void CompressorBenchmark::setUp(Compressor& compressor, const juce::dsp::ProcessSpec& spec)
+{
+    compressor.setThreshold(thresholdDb);
+    compressor.setRatio(ratio);
+    compressor.setAttack(attackMs);
+    compressor.setRelease(releaseMs);
+    
+    // juce::dsp::Compressor only has a hard knee
+    if constexpr( std::is_same_v<Compressor, FastCompressor<float>> )
+        compressor.setKnee(0.f);
+    
+    compressor.prepare(spec);
+}
+
+template<typename Compressor>
+float CompressorBenchmark::getStaticGainDb(Compressor& compressor, juce::AudioBuffer<float>& block, float levelDb, int numSamples)
+{
+    auto level = juce::Decibels::decibelsToGain(levelDb);
+    
+    for( int done = 0; done < numSamples; done += block.getNumSamples() )
+    {
+        for( int channel = 0; channel < block.getNumChannels(); ++channel )
+            juce::FloatVectorOperations::fill(block.getWritePointer(channel), level, block.getNumSamples());
+        
+        auto audioBlock = juce::dsp::AudioBlock<float>(block);
+        auto context = juce::dsp::ProcessContextReplacing<float>(audioBlock);
+        compressor.process(context);
+    }
+    
+    auto output = block.getSample(0, block.getNumSamples() - 1);
+    return juce::Decibels::gainToDecibels(output / level);
+}
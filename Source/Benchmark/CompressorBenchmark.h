@@ -0,0 +1,64 @@
+/*
+ ==============================================================================
+ 
+ CompressorBenchmark.h
+ Created: 17 Oct 2026 10:31:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorBenchmark.h"
+#include "../DSP/FastCompressor.h"
+
+//==============================================================================
+struct CompressorComparison
+{
+    BenchmarkResult fast, classic;      // total is the time per block
+    float maxCurveErrorDb { 0.f };      // worst gain difference over the sweep
+    
+    // FastMath's log2 and exp2 approximations stay well inside this
+    static constexpr float toleranceDb = 0.01f;
+    
+    bool passed() const { return maxCurveErrorDb <= toleranceDb; }
+};
+
+//==============================================================================
+/*
+ Compares FastCompressor with juce::dsp::Compressor at a hard knee, with the
+ same threshold, ratio and ballistics on both.
+ 
+ The static transfer curve is swept from sweepLowDb to sweepHighDb with a
+ constant input at each level, held until the envelopes have settled, and
+ the gains the two engines apply are compared in dB. Throughput is timed
+ on seeded noise, block by block, like processBlock.
+ */
+struct CompressorBenchmark
+{
+    explicit CompressorBenchmark(const BenchmarkSettings& settingsToUse);
+    
+    CompressorComparison run(const BenchmarkConfig& config);
+    
+    static constexpr float thresholdDb = -20.f;
+    static constexpr float ratio =       4.f;
+    static constexpr float attackMs =    1.f;
+    static constexpr float releaseMs =   50.f;
+    
+    static constexpr float sweepLowDb =  -60.f;
+    static constexpr float sweepHighDb = 6.f;
+    static constexpr float sweepStepDb = 0.5f;
+private:
+    BenchmarkSettings settings;
+    
+    template<typename Compressor>
+    static void setUp(Compressor& compressor, const juce::dsp::ProcessSpec& spec);
+    
+    // the gain, in dB, that compressor ends up applying to a constant input at levelDb
+    template<typename Compressor>
+    static float getStaticGainDb(Compressor& compressor, juce::AudioBuffer<float>& block, float levelDb, int numSamples);
+    
+    JUCE_DECLARE_NON_COPYABLE(CompressorBenchmark)
+};
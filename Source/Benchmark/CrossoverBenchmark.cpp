@@ -0,0 +1,196 @@
+/*
+ ==============================================================================
+ 
+ CrossoverBenchmark.cpp
+ Created: 17 Oct 2026 9:12:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "CrossoverBenchmark.h"
+#include <limits>
+
+namespace
+{
+constexpr auto numBands =      Params::NumBands;
+constexpr auto numCrossovers = Params::NumCrossovers;
+
+using Filter = juce::dsp::LinkwitzRileyFilter<float>;
+using Bands =  LinkwitzRileyCrossover<numBands>::BandBlocks;
+
+// the filter chain the processor ran before the fused crossover
+struct FilterChain
+{
+    std::array<Filter, numCrossovers> lowpasses, highpasses;
+    std::array<std::array<Filter, numBands>, numCrossovers> allpasses;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        for( size_t k = 0; k < numCrossovers; ++k )
+        {
+            auto frequency = Params::getCrossoverDefault(k);
+            
+            lowpasses[k].setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+            highpasses[k].setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+            
+            for( auto* filter : { &lowpasses[k], &highpasses[k] } )
+            {
+                filter->setCutoffFrequency(frequency);
+                filter->prepare(spec);
+            }
+            
+            for( auto& allpass : allpasses[k] )
+            {
+                allpass.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+                allpass.setCutoffFrequency(frequency);
+                allpass.prepare(spec);
+            }
+        }
+    }
+    
+    void process(const juce::dsp::AudioBlock<const float>& input,
+                 Bands& bands)
+    {
+        // the upper band carries whatever is above the last split
+        auto& upper = bands[numBands - 1];
+        upper.copyFrom(input);
+        
+        for( size_t k = 0; k < numCrossovers; ++k )
+        {
+            for( size_t band = 0; band < k; ++band )
+            {
+                auto context = juce::dsp::ProcessContextReplacing<float>(bands[band]);
+                allpasses[k][band].process(context);
+            }
+            
+            bands[k].copyFrom(upper);
+            
+            auto lowContext =  juce::dsp::ProcessContextReplacing<float>(bands[k]);
+            auto highContext = juce::dsp::ProcessContextReplacing<float>(upper);
+            lowpasses[k].process(lowContext);
+            highpasses[k].process(highContext);
+        }
+    }
+};
+
+Bands getBands(juce::AudioBuffer<float>& arena, int numChannels, int numSamples)
+{
+    Bands bands;
+    for( size_t band = 0; band < numBands; ++band )
+    {
+        bands[band] = juce::dsp::AudioBlock<float>(arena)
+                          .getSubsetChannelBlock(band * static_cast<size_t>(numChannels), static_cast<size_t>(numChannels))
+                          .getSubBlock(0, static_cast<size_t>(numSamples));
+    }
+    
+    return bands;
+}
+}
+
+//==============================================================================
+CrossoverBenchmark::CrossoverBenchmark(const BenchmarkSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+CrossoverComparison CrossoverBenchmark::run(const BenchmarkConfig& config)
+{
+    CrossoverComparison comparison;
+    comparison.simd.config = config;
+    comparison.filterChain.config = config;
+    
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = config.sampleRate;
+    spec.maximumBlockSize = static_cast<juce::uint32>(config.blockSize);
+    spec.numChannels = static_cast<juce::uint32>(config.numChannels);
+    
+    LinkwitzRileyCrossover<numBands> crossover;
+    crossover.setCutoffSmoothingEnabled(false);
+    
+    for( size_t k = 0; k < numCrossovers; ++k )
+        crossover.setCrossoverFrequency(k, Params::getCrossoverDefault(k));
+    
+    crossover.prepare(spec);
+    
+    FilterChain chain;
+    chain.prepare(spec);
+    
+    // a second of noise
+    auto noiseLength = juce::jmax(config.blockSize * 2, static_cast<int>(config.sampleRate));
+    juce::AudioBuffer<float> noise(config.numChannels, noiseLength);
+    fillWithNoise(noise);
+    
+    auto arenaChannels = config.numChannels * static_cast<int>(numBands);
+    juce::AudioBuffer<float> simdArena(arenaChannels, config.blockSize), chainArena(arenaChannels, config.blockSize);
+    
+    auto simdBands =  getBands(simdArena,  config.numChannels, config.blockSize);
+    auto chainBands = getBands(chainArena, config.numChannels, config.blockSize);
+    
+    // every pass reads the noise from the start, round and round
+    auto makeReader = [&]
+    {
+        return [&, position = 0]() mutable
+        {
+            if( position + config.blockSize > noiseLength )
+                position = 0;
+            
+            auto block = juce::dsp::AudioBlock<const float>(noise).getSubBlock(static_cast<size_t>(position),
+                                                                               static_cast<size_t>(config.blockSize));
+            position += config.blockSize;
+            return block;
+        };
+    };
+    
+    // a second of blocks through both, band by band
+    auto readSimd =  makeReader();
+    auto readChain = makeReader();
+    
+    for( int block = 0; block < noiseLength / config.blockSize; ++block )
+    {
+        crossover.process(readSimd(), simdBands);
+        chain.process(readChain(), chainBands);
+        
+        for( int channel = 0; channel < arenaChannels; ++channel )
+        {
+            auto* expected = chainArena.getReadPointer(channel);
+            auto* actual =   simdArena.getReadPointer(channel);
+            
+            for( int i = 0; i < config.blockSize; ++i )
+            {
+                // a NaN never compares, and fails the check outright
+                auto difference = std::abs(actual[i] - expected[i]);
+                comparison.maxDifference = std::isnan(difference) ? std::numeric_limits<float>::infinity()
+                                                                  : juce::jmax(comparison.maxDifference, difference);
+            }
+        }
+    }
+    
+    auto warmupBlocks = static_cast<int>(settings.warmupSeconds * config.sampleRate) / config.blockSize;
+    
+    auto time = [](auto&& process)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        process();
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e9;
+    };
+    
+    auto simdTimes = timeBlocks(settings, warmupBlocks, [&]
+    {
+        auto input = readSimd();
+        return time([&] { crossover.process(input, simdBands); });
+    });
+    
+    auto chainTimes = timeBlocks(settings, warmupBlocks, [&]
+    {
+        auto input = readChain();
+        return time([&] { chain.process(input, chainBands); });
+    });
+    
+    comparison.simd.iterations =        static_cast<int>(simdTimes.size());
+    comparison.simd.total =             Distribution::fromSamples(simdTimes);
+    comparison.filterChain.iterations = static_cast<int>(chainTimes.size());
+    comparison.filterChain.total =      Distribution::fromSamples(chainTimes);
+    
+    return comparison;
+}
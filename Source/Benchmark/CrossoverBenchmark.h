@@ -0,0 +1,45 @@
+/*
+ ==============================================================================
+ 
+ CrossoverBenchmark.h
+ Created: 17 Oct 2026 9:12:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorBenchmark.h"
+
+//==============================================================================
+struct CrossoverComparison
+{
+    BenchmarkResult simd, filterChain;  // total is the time per block
+    float maxDifference { 0.f };        // over every sample of every band
+    
+    // both run the same TPT math, only the order of rounding may differ
+    static constexpr float tolerance = 1.0e-5f;    // -100 dBFS
+    
+    bool passed() const { return maxDifference <= tolerance; }
+};
+
+//==============================================================================
+/*
+ Times LinkwitzRileyCrossover against the chain of juce::dsp::LinkwitzRileyFilter
+ it replaced: a lowpass and a highpass per split on the signal above it, and
+ an allpass per split on every band below it. Both split the same seeded
+ noise at the default crossover frequencies, block by block, and every band
+ of every block is compared.
+ */
+struct CrossoverBenchmark
+{
+    explicit CrossoverBenchmark(const BenchmarkSettings& settingsToUse);
+    
+    CrossoverComparison run(const BenchmarkConfig& config);
+private:
+    BenchmarkSettings settings;
+    
+    JUCE_DECLARE_NON_COPYABLE(CrossoverBenchmark)
+};
@@ -0,0 +1,610 @@
+/*
+ ==============================================================================
+ 
+ Main.cpp
+ Created: 10 Oct 2026 10:14:08am
+ Author:  Keith Hetrick
+ 
+ SimpleMBCompBenchmark: times processBlock over block sizes, sample rates and
+ channel counts, and prints the results the way Google Benchmark does.
+ 
+ ==============================================================================
+ */
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "AutomationCheck.h"
+#include "BlockSizeCheck.h"
+#include "CompressorBenchmark.h"
+#include "CrossoverBenchmark.h"
+#include "ProcessorBenchmark.h"
+#include "RealtimeCheck.h"
+#include "../Offline/OfflineRenderer.h"
+
+namespace
+{
+struct Options
+{
+    BenchmarkSettings settings;
+    juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    juce::Array<int> sampleRates { 44100, 48000, 96000, 192000 };
+    juce::Array<int> channelCounts { 1, 2 };
+    bool showStages { true };
+    bool compareDouble { false };
+    juce::File jsonOutput;
+    
+    bool realtimeCheck { false };
+    RealtimeCheckSettings checkSettings;
+    juce::Array<int> checkBlockSizes { 64, 512 };
+    
+    bool blockSizeCheck { false };
+    BlockSizeCheckSettings blockSizeCheckSettings;
+    
+    bool automationCheck { false };
+    AutomationCheckSettings automationCheckSettings;
+    
+    bool crossoverBenchmark { false };
+    bool compressorBenchmark { false };
+};
+
+void printUsage()
+{
+    std::cout << "usage: SimpleMBCompBenchmark [options]" << std::endl
+              << std::endl
+              << "  --block-sizes <list>  default 16,32,64,128,256,512,1024,2048,4096" << std::endl
+              << "  --rates <list>        default 44100,48000,96000,192000" << std::endl
+              << "  --channels <list>     default 1,2, up to 12; 6, 8 and 12 are 5.1, 7.1 and 7.1.4" << std::endl
+              << "  --min-time <s>        timed processBlock calls per config, default 0.2" << std::endl
+              << "  --preset <file>       processor state, as saved by a host or as XML" << std::endl
+              << "  --no-stages           only time processBlock as a whole" << std::endl
+              << "  --double              also time the double precision path, next to every float config" << std::endl
+              << "  --json <file>         also write the results as Google Benchmark JSON" << std::endl
+              << "  --rt-check            instead of timing, check that processBlock never allocates" << std::endl
+              << "                        or locks, with and without a sidechain, block sizes" << std::endl
+              << "                        default 64,512 (Debug builds only)" << std::endl
+              << "  --block-size-check    instead of timing, check that the output doesn't depend on" << std::endl
+              << "                        the host's block size, for both crossover modes, and always on 5.1" << std::endl
+              << "  --automation-check    instead of timing, check that automated parameters reach their" << std::endl
+              << "                        new values, with host blocks of 32, 64 and 512" << std::endl
+              << "  --crossover           instead of processBlock, time the SIMD crossover against the" << std::endl
+              << "                        juce::dsp::LinkwitzRileyFilter chain, and check their bands match" << std::endl
+              << "  --compressor          instead of processBlock, time FastCompressor against" << std::endl
+              << "                        juce::dsp::Compressor, and check their hard knee curves match" << std::endl;
+}
+
+juce::Array<int> parseList(const juce::String& list)
+{
+    juce::Array<int> values;
+    for( const auto& token : juce::StringArray::fromTokens(list, ",", {}) )
+    {
+        auto value = token.trim().getIntValue();
+        if( value > 0 )
+            values.add(value);
+    }
+    
+    return values;
+}
+
+juce::Result parseOptions(const juce::StringArray& args, Options& options)
+{
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    
+    for( int i = 0; i < args.size(); ++i )
+    {
+        const auto& arg = args[i];
+        
+        if( arg == "--no-stages" )
+        {
+            options.showStages = false;
+            continue;
+        }
+        
+        if( arg == "--double" )
+        {
+            options.compareDouble = true;
+            continue;
+        }
+        
+        if( arg == "--rt-check" )
+        {
+            options.realtimeCheck = true;
+            continue;
+        }
+        
+        if( arg == "--block-size-check" )
+        {
+            options.blockSizeCheck = true;
+            continue;
+        }
+        
+        if( arg == "--automation-check" )
+        {
+            options.automationCheck = true;
+            continue;
+        }
+        
+        if( arg == "--crossover" )
+        {
+            options.crossoverBenchmark = true;
+            continue;
+        }
+        
+        if( arg == "--compressor" )
+        {
+            options.compressorBenchmark = true;
+            continue;
+        }
+        
+        if( i + 1 >= args.size() )
+            return juce::Result::fail(arg + " needs a value");
+        
+        const auto& value = args[++i];
+        
+        if( arg == "--block-sizes" )
+            options.blockSizes = options.checkBlockSizes = parseList(value);
+        else if( arg == "--rates" )
+            options.sampleRates = parseList(value);
+        else if( arg == "--channels" )
+            options.channelCounts = parseList(value);
+        else if( arg == "--min-time" )
+            options.settings.minSeconds = value.getDoubleValue();
+        else if( arg == "--json" )
+            options.jsonOutput = cwd.getChildFile(value);
+        else if( arg == "--preset" )
+        {
+            auto result = OfflineRenderer::loadPreset(cwd.getChildFile(value), options.settings.preset);
+            if( result.failed() )
+                return result;
+            
+            options.checkSettings.preset = options.settings.preset;
+            options.blockSizeCheckSettings.preset = options.settings.preset;
+        }
+        else
+            return juce::Result::fail("unknown option " + arg);
+    }
+    
+    if( options.blockSizes.isEmpty() || options.sampleRates.isEmpty() || options.channelCounts.isEmpty() )
+        return juce::Result::fail("nothing to run");
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        if( numChannels < 1 || numChannels > SimpleMBCompAudioProcessor::maxMainChannels )
+            return juce::Result::fail("channel counts go from 1 to " + juce::String(SimpleMBCompAudioProcessor::maxMainChannels));
+    }
+    
+    if( options.realtimeCheck && ! RealtimeGuard::isAvailable() )
+        return juce::Result::fail("--rt-check needs a build with SIMPLEMBCOMP_RT_GUARD, which the Debug configuration has");
+    
+    return juce::Result::ok();
+}
+
+//==============================================================================
+int runRealtimeCheck(const Options& options)
+{
+    RealtimeCheck check(options.checkSettings);
+    auto numFailed = 0;
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            for( auto blockSize : options.checkBlockSizes )
+            {
+                for( auto sidechain : { false, true } )
+                {
+                    BenchmarkConfig config;
+                    config.numChannels = numChannels;
+                    config.sampleRate = static_cast<double>(sampleRate);
+                    config.blockSize = blockSize;
+                    config.sidechain = sidechain;
+                    
+                    auto result = check.run(config);
+                    
+                    auto line = config.getName().paddedRight(' ', 44)
+                              + " blocks=" + juce::String(result.numBlocks)
+                              + " oversized=" + juce::String(result.numOversizedBlocks)
+                              + " changes=" + juce::String(result.numParameterChanges);
+                    
+                    for( int violation = 0; violation < RealtimeGuard::NumViolations; ++violation )
+                        line << " " << RealtimeGuard::getName(violation) << "=" << juce::String(result.violations.counts[static_cast<size_t>(violation)]);
+                    
+                    line << " non-finite=" << juce::String(result.numNonFiniteSamples)
+                         << (result.passed() ? "  ok" : "  FAILED");
+                    
+                    std::cout << line << std::endl;
+                    
+                    if( ! result.passed() )
+                        ++numFailed;
+                }
+            }
+        }
+    }
+    
+    if( numFailed > 0 )
+    {
+        std::cerr << numFailed << " config(s) failed" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+int runBlockSizeCheck(const Options& options)
+{
+    BlockSizeCheck check(options.blockSizeCheckSettings);
+    auto numFailed = 0;
+    
+    // linear phase splits a surround bus into channel pairs, so 5.1 is always checked
+    auto channelCounts = options.channelCounts;
+    channelCounts.addIfNotAlreadyThere(6);
+    
+    for( auto numChannels : channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            for( auto linearPhase : { false, true } )
+            {
+                BenchmarkConfig config;
+                config.numChannels = numChannels;
+                config.sampleRate = static_cast<double>(sampleRate);
+                
+                auto name = config.getName() + (linearPhase ? "/linear_phase" : "/minimum_phase");
+                
+                for( const auto& result : check.run(config, linearPhase) )
+                {
+                    auto maxDifference = result.maxDifference > 0.f ? juce::String(juce::Decibels::gainToDecibels(result.maxDifference), 1) + " dBFS"
+                                                                    : juce::String("none");
+                    
+                    std::cout << (name + "/host_" + juce::String(result.hostBlockSize)).paddedRight(' ', 56)
+                              << " differing samples=" << result.numDifferentSamples
+                              << " max difference=" << maxDifference
+                              << " silent channels=" << result.numSilentChannels
+                              << (result.passed() ? "  ok" : "  FAILED") << std::endl;
+                    
+                    if( ! result.passed() )
+                        ++numFailed;
+                }
+            }
+        }
+    }
+    
+    if( numFailed > 0 )
+    {
+        std::cerr << numFailed << " block size(s) failed" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+int runAutomationCheck(const Options& options)
+{
+    AutomationCheck check(options.automationCheckSettings);
+    auto numFailed = 0;
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            BenchmarkConfig config;
+            config.numChannels = numChannels;
+            config.sampleRate = static_cast<double>(sampleRate);
+            
+            for( const auto& result : check.run(config) )
+            {
+                auto maxDifference = result.maxDifference > 0.f ? juce::String(juce::Decibels::gainToDecibels(result.maxDifference), 1) + " dBFS"
+                                                                : juce::String("none");
+                
+                std::cout << result.name.paddedRight(' ', 56)
+                          << " max difference=" << maxDifference
+                          << (result.passed() ? "  ok" : "  FAILED") << std::endl;
+                
+                if( ! result.passed() )
+                    ++numFailed;
+            }
+        }
+    }
+    
+    if( numFailed > 0 )
+    {
+        std::cerr << numFailed << " change(s) failed" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+//==============================================================================
+juce::String formatNs(double ns)
+{
+    return juce::String(juce::roundToInt(ns));
+}
+
+void printHeader()
+{
+    auto rule = juce::String::repeatedString("-", 110);
+    
+    std::cout << juce::Time::getCurrentTime().toISO8601(true) << std::endl
+              << "Running SimpleMBCompBenchmark" << std::endl
+              << "Run on (" << juce::SystemStats::getNumCpus() << " X "
+              << juce::SystemStats::getCpuSpeedInMegahertz() << " MHz CPU s)" << std::endl
+#if JUCE_DEBUG
+              << "***WARNING*** Library was built as DEBUG. Timings may be affected." << std::endl
+#endif
+              << rule << std::endl
+              << juce::String("Benchmark").paddedRight(' ', 44)
+              << juce::String("Time").paddedLeft(' ', 14)
+              << juce::String("Iterations").paddedLeft(' ', 12)
+              << " UserCounters..." << std::endl
+              << rule << std::endl;
+}
+
+juce::String getCounters(const BenchmarkResult& result, const Distribution& distribution)
+{
+    return "ns/sample=" + juce::String(result.getNsPerSample(distribution), 2)
+         + " p50=" + formatNs(distribution.p50)
+         + " p90=" + formatNs(distribution.p90)
+         + " p99=" + formatNs(distribution.p99)
+         + " max=" + formatNs(distribution.max);
+}
+
+void printRow(const juce::String& name, const BenchmarkResult& result, const Distribution& distribution)
+{
+    std::cout << name.paddedRight(' ', 44)
+              << (formatNs(distribution.mean) + " ns").paddedLeft(' ', 14)
+              << juce::String(result.iterations).paddedLeft(' ', 12)
+              << " " << getCounters(result, distribution) << std::endl;
+}
+
+juce::var makeJsonRow(const juce::String& name, const BenchmarkResult& result, const Distribution& distribution)
+{
+    auto* row = new juce::DynamicObject();
+    row->setProperty("name",        name);
+    row->setProperty("run_name",    name);
+    row->setProperty("run_type",    "iteration");
+    row->setProperty("iterations",  result.iterations);
+    row->setProperty("real_time",   distribution.mean);
+    row->setProperty("cpu_time",    distribution.mean);
+    row->setProperty("time_unit",   "ns");
+    row->setProperty("ns_per_sample", result.getNsPerSample(distribution));
+    row->setProperty("p50",         distribution.p50);
+    row->setProperty("p90",         distribution.p90);
+    row->setProperty("p99",         distribution.p99);
+    row->setProperty("max",         distribution.max);
+    return juce::var(row);
+}
+
+juce::var makeJsonContext()
+{
+    auto* context = new juce::DynamicObject();
+    context->setProperty("date",        juce::Time::getCurrentTime().toISO8601(true));
+    context->setProperty("host_name",   juce::SystemStats::getComputerName());
+    context->setProperty("executable",  juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName());
+    context->setProperty("num_cpus",    juce::SystemStats::getNumCpus());
+    context->setProperty("mhz_per_cpu", juce::SystemStats::getCpuSpeedInMegahertz());
+    context->setProperty("cpu_model",   juce::SystemStats::getCpuModel());
+#if JUCE_DEBUG
+    context->setProperty("library_build_type", "debug");
+#else
+    context->setProperty("library_build_type", "release");
+#endif
+    return juce::var(context);
+}
+
+bool writeJson(const juce::File& file, const juce::Array<juce::var>& rows)
+{
+    auto* root = new juce::DynamicObject();
+    root->setProperty("context",    makeJsonContext());
+    root->setProperty("benchmarks", rows);
+    
+    if( file.replaceWithText(juce::JSON::toString(juce::var(root))) )
+        return true;
+    
+    std::cerr << "can't write " << file.getFullPathName() << std::endl;
+    return false;
+}
+
+//==============================================================================
+int runCrossoverBenchmark(const Options& options)
+{
+    CrossoverBenchmark benchmark(options.settings);
+    juce::Array<juce::var> rows;
+    auto numFailed = 0;
+    
+    printHeader();
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            for( auto blockSize : options.blockSizes )
+            {
+                BenchmarkConfig config;
+                config.numChannels = numChannels;
+                config.sampleRate = static_cast<double>(sampleRate);
+                config.blockSize = blockSize;
+                
+                auto comparison = benchmark.run(config);
+                auto name = config.getName("crossover");
+                
+                auto addRow = [&rows](const juce::String& rowName, const BenchmarkResult& result)
+                {
+                    printRow(rowName, result, result.total);
+                    rows.add(makeJsonRow(rowName, result, result.total));
+                };
+                
+                addRow(name + "/simd",         comparison.simd);
+                addRow(name + "/filter_chain", comparison.filterChain);
+                
+                auto maxDifference = comparison.maxDifference > 0.f ? juce::String(juce::Decibels::gainToDecibels(comparison.maxDifference), 1) + " dBFS"
+                                                                    : juce::String("none");
+                
+                std::cout << (name + "/bands").paddedRight(' ', 44)
+                          << " speedup=" << juce::String(comparison.filterChain.total.mean / comparison.simd.total.mean, 2) << "x"
+                          << " max difference=" << maxDifference
+                          << (comparison.passed() ? "  ok" : "  FAILED") << std::endl;
+                
+                if( ! comparison.passed() )
+                    ++numFailed;
+            }
+        }
+    }
+    
+    if( options.jsonOutput != juce::File() && ! writeJson(options.jsonOutput, rows) )
+        return 1;
+    
+    if( numFailed > 0 )
+    {
+        std::cerr << numFailed << " config(s) failed" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+//==============================================================================
+int runCompressorBenchmark(const Options& options)
+{
+    CompressorBenchmark benchmark(options.settings);
+    juce::Array<juce::var> rows;
+    auto numFailed = 0;
+    
+    printHeader();
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            for( auto blockSize : options.blockSizes )
+            {
+                BenchmarkConfig config;
+                config.numChannels = numChannels;
+                config.sampleRate = static_cast<double>(sampleRate);
+                config.blockSize = blockSize;
+                
+                auto comparison = benchmark.run(config);
+                auto name = config.getName("compressor");
+                
+                auto addRow = [&rows](const juce::String& rowName, const BenchmarkResult& result)
+                {
+                    printRow(rowName, result, result.total);
+                    rows.add(makeJsonRow(rowName, result, result.total));
+                };
+                
+                addRow(name + "/fast",    comparison.fast);
+                addRow(name + "/classic", comparison.classic);
+                
+                std::cout << (name + "/curve").paddedRight(' ', 44)
+                          << " speedup=" << juce::String(comparison.classic.total.mean / comparison.fast.total.mean, 2) << "x"
+                          << " max curve error=" << juce::String(comparison.maxCurveErrorDb, 5) << " dB"
+                          << (comparison.passed() ? "  ok" : "  FAILED") << std::endl;
+                
+                if( ! comparison.passed() )
+                    ++numFailed;
+            }
+        }
+    }
+    
+    if( options.jsonOutput != juce::File() && ! writeJson(options.jsonOutput, rows) )
+        return 1;
+    
+    if( numFailed > 0 )
+    {
+        std::cerr << numFailed << " config(s) failed" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    
+    juce::StringArray args;
+    for( int i = 1; i < argc; ++i )
+    {
+        args.add(juce::CharPointer_UTF8(argv[i]));
+    }
+    
+    if( args.contains("-h") || args.contains("--help") )
+    {
+        printUsage();
+        return 0;
+    }
+    
+    Options options;
+    auto result = parseOptions(args, options);
+    if( result.failed() )
+    {
+        std::cerr << result.getErrorMessage() << std::endl << std::endl;
+        printUsage();
+        return 1;
+    }
+    
+    if( options.realtimeCheck )
+        return runRealtimeCheck(options);
+    
+    if( options.blockSizeCheck )
+        return runBlockSizeCheck(options);
+    
+    if( options.automationCheck )
+        return runAutomationCheck(options);
+    
+    if( options.crossoverBenchmark )
+        return runCrossoverBenchmark(options);
+    
+    if( options.compressorBenchmark )
+        return runCompressorBenchmark(options);
+    
+    ProcessorBenchmark benchmark(options.settings);
+    juce::Array<juce::var> rows;
+    
+    printHeader();
+    
+    for( auto numChannels : options.channelCounts )
+    {
+        for( auto sampleRate : options.sampleRates )
+        {
+            for( auto blockSize : options.blockSizes )
+            {
+                for( auto doublePrecision : { false, true } )
+                {
+                    if( doublePrecision && ! options.compareDouble )
+                        break;
+                    
+                    BenchmarkConfig config;
+                    config.numChannels = numChannels;
+                    config.sampleRate = static_cast<double>(sampleRate);
+                    config.blockSize = blockSize;
+                    config.doublePrecision = doublePrecision;
+                    
+                    auto benchmarkResult = benchmark.run(config);
+                    auto name = config.getName();
+                    
+                    printRow(name, benchmarkResult, benchmarkResult.total);
+                    rows.add(makeJsonRow(name, benchmarkResult, benchmarkResult.total));
+                    
+                    if( ! options.showStages )
+                        continue;
+                    
+                    for( int stage = 0; stage < StageProfiler::NumStages; ++stage )
+                    {
+                        auto stageName = name + "/" + StageProfiler::getStageName(stage).replaceCharacter(' ', '_');
+                        const auto& distribution = benchmarkResult.stages[static_cast<size_t>(stage)];
+                        
+                        printRow(stageName, benchmarkResult, distribution);
+                        rows.add(makeJsonRow(stageName, benchmarkResult, distribution));
+                    }
+                }
+            }
+        }
+    }
+    
+    if( options.jsonOutput != juce::File() && ! writeJson(options.jsonOutput, rows) )
+        return 1;
+    
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ ==============================================================================
+ 
+ ProcessorBenchmark.cpp
+ Created: 10 Oct 2026 9:31:22am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "ProcessorBenchmark.h"
+#include <algorithm>
+
+namespace
+{
+double getPercentile(const std::vector<double>& sorted, double percentile)
+{
+    auto index = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[juce::jlimit(size_t(0), sorted.size() - 1, index > 0 ? index - 1 : 0)];
+}
+}
+
+//==============================================================================
+bool prepareProcessor(SimpleMBCompAudioProcessor& processor, const BenchmarkConfig& config, const juce::MemoryBlock& preset)
+{
+    auto channelSet = SimpleMBCompAudioProcessor::getMainLayout(config.numChannels);
+    
+    // the sidechain bus takes mono or stereo only
+    auto sidechainSet = config.numChannels == 1 ? channelSet : juce::AudioChannelSet::stereo();
+    
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    
+    for( int bus = 1; bus < processor.getBusCount(true); ++bus )
+        layout.inputBuses.add(bus == 1 && config.sidechain ? sidechainSet : juce::AudioChannelSet::disabled());
+    
+    if( ! processor.setBusesLayout(layout) )
+        return false;
+    
+    if( preset.getSize() > 0 )
+        processor.setStateInformation(preset.getData(), static_cast<int>(preset.getSize()));
+    
+    processor.setProcessingPrecision(config.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                            : juce::AudioProcessor::singlePrecision);
+    
+    processor.setRateAndBufferSizeDetails(config.sampleRate, config.blockSize);
+    processor.prepareToPlay(config.sampleRate, config.blockSize);
+    processor.reset();
+    
+    return true;
+}
+
+juce::String BenchmarkConfig::getName(const juce::String& benchmark) const
+{
+    auto channels = numChannels == 1 ? juce::String("mono")
+                  : numChannels == 2 ? juce::String("stereo")
+                                     : juce::String(numChannels) + "ch";
+    
+    return benchmark + "/" + channels + "/" + juce::String(juce::roundToInt(sampleRate)) + "/" + juce::String(blockSize)
+         + (sidechain ? "/sidechain" : "")
+         + (doublePrecision ? "/double" : "");
+}
+
+Distribution Distribution::fromSamples(std::vector<double>& samples)
+{
+    Distribution distribution;
+    if( samples.empty() )
+        return distribution;
+    
+    std::sort(samples.begin(), samples.end());
+    
+    auto sum = 0.0;
+    for( auto sample : samples )
+        sum += sample;
+    
+    distribution.mean = sum / static_cast<double>(samples.size());
+    distribution.p50 =  getPercentile(samples, 50.0);
+    distribution.p90 =  getPercentile(samples, 90.0);
+    distribution.p99 =  getPercentile(samples, 99.0);
+    distribution.max =  samples.back();
+    
+    return distribution;
+}
+
+//==============================================================================
+ProcessorBenchmark::ProcessorBenchmark(const BenchmarkSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+BenchmarkResult ProcessorBenchmark::run(const BenchmarkConfig& config)
+{
+    SimpleMBCompAudioProcessor processor;
+    if( ! prepareProcessor(processor, config, settings.preset) )
+    {
+        jassertfalse;
+        BenchmarkResult result;
+        result.config = config;
+        return result;
+    }
+    
+    if( config.doublePrecision )
+        return run<double>(config, processor);
+    
+    return run<float>(config, processor);
+}
+
+template<typename SampleType>
+BenchmarkResult ProcessorBenchmark::run(const BenchmarkConfig& config, SimpleMBCompAudioProcessor& processor)
+{
+    BenchmarkResult result;
+    result.config = config;
+    
+    // a second of seeded noise at -6 dBFS, read round and round
+    auto noiseLength = juce::jmax(config.blockSize * 2, static_cast<int>(config.sampleRate));
+    juce::AudioBuffer<SampleType> noise(config.numChannels, noiseLength);
+    fillWithNoise(noise);
+    
+    juce::AudioBuffer<SampleType> block(config.numChannels, config.blockSize);
+    juce::MidiBuffer midi;
+    int position = 0;
+    
+    auto processNextBlock = [&]()
+    {
+        if( position + config.blockSize > noiseLength )
+            position = 0;
+        
+        for( int channel = 0; channel < config.numChannels; ++channel )
+            block.copyFrom(channel, 0, noise, channel, position, config.blockSize);
+        
+        position += config.blockSize;
+        
+        auto start = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        auto ticks = juce::Time::getHighResolutionTicks() - start;
+        
+        // what the editor's timer would do
+        processor.updateMeterHistory();
+        
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9;
+    };
+    
+    auto warmupBlocks = static_cast<int>(settings.warmupSeconds * config.sampleRate) / config.blockSize;
+    auto totals = timeBlocks(settings, warmupBlocks, processNextBlock);
+    
+    result.iterations = static_cast<int>(totals.size());
+    result.total = Distribution::fromSamples(totals);
+    
+    // the same number of calls again, stage by stage
+    StageProfiler profiler;
+    processor.setStageProfiler(&profiler);
+    
+    std::array<std::vector<double>, StageProfiler::NumStages> stageSamples;
+    for( auto& samples : stageSamples )
+        samples.reserve(static_cast<size_t>(result.iterations));
+    
+    for( int i = 0; i < result.iterations; ++i )
+    {
+        profiler.reset();
+        processNextBlock();
+        
+        for( int stage = 0; stage < StageProfiler::NumStages; ++stage )
+            stageSamples[static_cast<size_t>(stage)].push_back(profiler.getSeconds(stage) * 1.0e9);
+    }
+    
+    processor.setStageProfiler(nullptr);
+    
+    for( size_t stage = 0; stage < stageSamples.size(); ++stage )
+        result.stages[stage] = Distribution::fromSamples(stageSamples[stage]);
+    
+    return result;
+}
@@ -0,0 +1,129 @@
+/*
+ ==============================================================================
+ 
+ ProcessorBenchmark.h
+ Created: 10 Oct 2026 9:31:22am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "../PluginProcessor.h"
+
+//==============================================================================
+struct BenchmarkConfig
+{
+    int numChannels { 2 };
+    double sampleRate { 48000.0 };
+    int blockSize { 512 };
+    bool sidechain { false };   // a mono sidechain for a mono bus, stereo otherwise
+    bool doublePrecision { false };
+    
+    // processBlock/stereo/48000/512, with /sidechain and /double when they're on;
+    // benchmarks of a single stage put their own name first
+    juce::String getName(const juce::String& benchmark = "processBlock") const;
+};
+
+// sets the buses up for config, loads preset if there is one, and prepares
+bool prepareProcessor(SimpleMBCompAudioProcessor& processor, const BenchmarkConfig& config, const juce::MemoryBlock& preset);
+
+struct BenchmarkSettings
+{
+    juce::MemoryBlock preset;   // processor state, empty for the defaults
+    double warmupSeconds { 0.5 };
+    double minSeconds { 0.2 };  // of timed processBlock calls per config
+    int minIterations { 100 };
+};
+
+// nanoseconds per processBlock call
+struct Distribution
+{
+    double mean { 0.0 };
+    double p50 { 0.0 }, p90 { 0.0 }, p99 { 0.0 }, max { 0.0 };
+    
+    // sorts samples
+    static Distribution fromSamples(std::vector<double>& samples);
+};
+
+/*
+ Calls timeNextBlock, which processes one block and returns how long that
+ took in nanoseconds, warmupBlocks times untimed and then until both of
+ settings' minimums are reached. Returns the timed calls.
+ */
+template<typename Function>
+std::vector<double> timeBlocks(const BenchmarkSettings& settings, int warmupBlocks, Function&& timeNextBlock)
+{
+    for( int i = 0; i < warmupBlocks; ++i )
+        timeNextBlock();
+    
+    std::vector<double> times;
+    times.reserve(static_cast<size_t>(settings.minIterations));
+    
+    auto elapsed = 0.0;
+    while( elapsed < settings.minSeconds * 1.0e9 || static_cast<int>(times.size()) < settings.minIterations )
+    {
+        times.push_back(timeNextBlock());
+        elapsed += times.back();
+    }
+    
+    return times;
+}
+
+// seeded noise at -6 dBFS, the same on every run
+template<typename SampleType>
+void fillWithNoise(juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::Random random(0x5eed);
+    
+    for( int channel = 0; channel < buffer.getNumChannels(); ++channel )
+    {
+        auto* samples = buffer.getWritePointer(channel);
+        for( int i = 0; i < buffer.getNumSamples(); ++i )
+        {
+            samples[i] = static_cast<SampleType>(random.nextFloat() - 0.5f);
+        }
+    }
+}
+
+struct BenchmarkResult
+{
+    BenchmarkConfig config;
+    int iterations { 0 };
+    
+    Distribution total;
+    std::array<Distribution, StageProfiler::NumStages> stages;
+    
+    double getNsPerSample(const Distribution& distribution) const
+    {
+        return distribution.mean / config.blockSize;
+    }
+};
+
+//==============================================================================
+/*
+ Times processBlock on a processor set up for one config.
+ 
+ Every config gets a fresh processor, fed the same seeded noise, so runs are
+ repeatable and the float and double paths of a config hear the same samples.
+ The calls are timed twice: once with no profiler attached for the totals, and
+ once with a StageProfiler for the per stage numbers, which then include the
+ profiler's few clock reads per block.
+ */
+struct ProcessorBenchmark
+{
+    explicit ProcessorBenchmark(const BenchmarkSettings& settingsToUse);
+    
+    BenchmarkResult run(const BenchmarkConfig& config);
+private:
+    BenchmarkSettings settings;
+    
+    template<typename SampleType>
+    BenchmarkResult run(const BenchmarkConfig& config, SimpleMBCompAudioProcessor& processor);
+    
+    JUCE_DECLARE_NON_COPYABLE(ProcessorBenchmark)
+};
@@ -0,0 +1,104 @@
+/*
+ ==============================================================================
+ 
+ RealtimeCheck.cpp
+ Created: 13 Oct 2026 11:02:16am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "RealtimeCheck.h"
+
+namespace
+{
+constexpr juce::int64 checkSeed = 0xb10c;
+
+int getNextBlockSize(juce::Random& random, int preparedBlockSize)
+{
+    // mostly what was announced, then everything from tiny to oversized
+    switch( random.nextInt(4) )
+    {
+        case 0:
+        case 1:     return preparedBlockSize;
+        case 2:     return 1 + random.nextInt(preparedBlockSize);
+        default:    break;
+    }
+    
+    return preparedBlockSize + 1 + random.nextInt(preparedBlockSize * 3);
+}
+}
+
+//==============================================================================
+RealtimeCheck::RealtimeCheck(const RealtimeCheckSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+}
+
+RealtimeCheckResult RealtimeCheck::run(const BenchmarkConfig& config)
+{
+    RealtimeCheckResult result;
+    result.config = config;
+    
+    SimpleMBCompAudioProcessor processor;
+    if( ! prepareProcessor(processor, config, settings.preset) )
+    {
+        jassertfalse;
+        return result;
+    }
+    
+    auto& parameters = processor.getParameters();
+    juce::Random random(checkSeed);
+    
+    // room for the largest block, main and sidechain channels alike
+    auto numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+    juce::AudioBuffer<float> buffer(numChannels, config.blockSize * 4);
+    juce::MidiBuffer midi;
+    
+    // the first blocks allocate nothing either, so they're checked too
+    RealtimeGuard::resetCounts();
+    
+    for( int block = 0; block < settings.numBlocks; ++block )
+    {
+        if( block % settings.parameterChangeInterval == 0 )
+        {
+            auto* parameter = parameters[random.nextInt(parameters.size())];
+            parameter->setValueNotifyingHost(random.nextFloat());
+            ++result.numParameterChanges;
+        }
+        
+        auto numSamples = getNextBlockSize(random, config.blockSize);
+        if( numSamples > config.blockSize )
+            ++result.numOversizedBlocks;
+        
+        // a host hands over a buffer of exactly the block's size
+        juce::AudioBuffer<float> hostBuffer(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+        
+        for( int channel = 0; channel < hostBuffer.getNumChannels(); ++channel )
+        {
+            auto* samples = hostBuffer.getWritePointer(channel);
+            for( int i = 0; i < numSamples; ++i )
+            {
+                samples[i] = random.nextFloat() - 0.5f;
+            }
+        }
+        
+        processor.processBlock(hostBuffer, midi);
+        
+        for( int channel = 0; channel < processor.getTotalNumOutputChannels(); ++channel )
+        {
+            auto* samples = hostBuffer.getReadPointer(channel);
+            for( int i = 0; i < numSamples; ++i )
+            {
+                if( ! std::isfinite(samples[i]) )
+                    ++result.numNonFiniteSamples;
+            }
+        }
+        
+        processor.updateMeterHistory();
+        ++result.numBlocks;
+    }
+    
+    result.violations = RealtimeGuard::getCounts();
+    return result;
+}
@@ -0,0 +1,57 @@
+/*
+ ==============================================================================
+ 
+ RealtimeCheck.h
+ Created: 13 Oct 2026 11:02:16am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessorBenchmark.h"
+
+//==============================================================================
+struct RealtimeCheckSettings
+{
+    juce::MemoryBlock preset;   // processor state, empty for the defaults
+    int numBlocks { 2000 };     // per config
+    int parameterChangeInterval { 4 };  // blocks
+};
+
+struct RealtimeCheckResult
+{
+    BenchmarkConfig config;
+    int numBlocks { 0 };
+    int numOversizedBlocks { 0 };
+    int numParameterChanges { 0 };
+    juce::int64 numNonFiniteSamples { 0 };
+    
+    RealtimeGuard::Counts violations;
+    
+    bool passed() const { return violations.getTotal() == 0 && numNonFiniteSamples == 0; }
+};
+
+//==============================================================================
+/*
+ Drives a processor the way a host might, with processBlock running inside
+ RealtimeGuard's scope, and counts what the audio thread did that it shouldn't.
+ 
+ Between blocks, a random parameter is moved every parameterChangeInterval
+ blocks, engines, detectors and the crossover mode included. Block sizes are
+ drawn at random from 1 sample up to four times the prepared size, so the
+ slicing of oversized blocks is covered too. Everything is seeded, so a
+ failing config fails the same way every time.
+ */
+struct RealtimeCheck
+{
+    explicit RealtimeCheck(const RealtimeCheckSettings& settingsToUse);
+    
+    RealtimeCheckResult run(const BenchmarkConfig& config);
+private:
+    RealtimeCheckSettings settings;
+    
+    JUCE_DECLARE_NON_COPYABLE(RealtimeCheck)
+};
@@ -9,38 +9,500 @@
  */
 
 #include "CompressorBand.h"
+#include "Params.h"
+
+void CompressorBand::listenForSettingsChanges()
+{
+    settings.add({ attack, release, threshold, ratio, knee, engine, lookahead, detector });
+    
+    attackRamp.setParameter(attack);
+    releaseRamp.setParameter(release);
+    thresholdRamp.setParameter(threshold);
+    kneeRamp.setParameter(knee);
+}
 
 void CompressorBand::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    compressor.prepare(spec);
+    sampleRate = spec.sampleRate;
+    maxLookaheadSamples = static_cast<int>(std::ceil(MAX_LOOKAHEAD_MS * 0.001 * sampleRate));
+    
+    // the processor runs in whichever precision the host asks for, so both are ready
+    forEachDsp([&](auto& dsp)
+    {
+        dsp.compressor.prepare(spec);
+        dsp.fastCompressor.prepare(spec);
+        
+        dsp.delayLine.setMaximumDelayInSamples(maxLookaheadSamples);
+        dsp.delayLine.prepare(spec);
+        
+        dsp.sidechainDelayLine.setMaximumDelayInSamples(maxLookaheadSamples);
+        dsp.sidechainDelayLine.prepare(spec);
+        
+        dsp.detectorBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    });
+    
+    updateKeySides(juce::AudioChannelSet::canonicalChannelSet(static_cast<int>(spec.numChannels)));
+    
+    lookaheadSamples = 0;
+    alignmentDelay = 0;
+    
+    alignmentFadeSamples = juce::jmax(1, juce::roundToInt(alignmentFadeSeconds * sampleRate));
+    alignmentFadeRemaining = 0;
+    
+    historyFrameSamples = juce::jmax(1, juce::roundToInt(historyFrameSeconds * sampleRate));
+    samplesUntilFrame = historyFrameSamples;
+    frameLevels.clear();
+    
+    for( auto* ramp : { &attackRamp, &releaseRamp, &thresholdRamp, &kneeRamp } )
+        ramp->snap();
+    
+    ramping = false;
+    settings.markDirty();
+}
+
+void CompressorBand::setChannelLayout(const juce::AudioChannelSet& layout)
+{
+    forEachDsp([&](auto& dsp)
+    {
+        dsp.fastCompressor.setChannelLayout(layout);
+    });
+    
+    updateKeySides(layout);
+}
+
+void CompressorBand::reset()
+{
+    forEachDsp([](auto& dsp)
+    {
+        dsp.compressor.reset();
+        dsp.fastCompressor.reset();
+        
+        dsp.delayLine.reset();
+        dsp.sidechainDelayLine.reset();
+    });
+    
+    alignmentFadeRemaining = 0;
+    meter.store(MeterReading());
 }
 
-void CompressorBand::updateCompressorSettings()
+bool CompressorBand::beginAutomation() noexcept
 {
-    compressor.setAttack    (attack->get());
-    compressor.setRelease   (release->get());
-    compressor.setThreshold (threshold->get());
-    compressor.setRatio     ( ratio->getCurrentChoiceName().getFloatValue() );
+    auto moving = false;
+    for( auto* ramp : { &attackRamp, &releaseRamp, &thresholdRamp, &kneeRamp } )
+        moving = ramp->begin() || moving;
+    
+    // a ramp the settings haven't caught up with yet, e.g. because the last
+    // host block had no sub-block start in it, is still followed
+    ramping = moving || ramping;
+    return ramping;
 }
 
-void CompressorBand::process(juce::AudioBuffer<float>& buffer)
+void CompressorBand::updateCompressorSettings(float proportion, bool followRamps)
 {
-    auto preRMS = computeRMSLevel(buffer);
+    auto changed = settings.consumeChange();
+    if( ! changed && ! (followRamps && ramping) )
+        return;
     
-    auto block =   juce::dsp::AudioBlock<float>(buffer);
-    auto context = juce::dsp::ProcessContextReplacing<float>(block);
+    auto ratioValue =     Params::getRatio(ratio->getIndex());
+    auto attackValue =    attackRamp.getValue(proportion);
+    auto releaseValue =   releaseRamp.getValue(proportion);
+    auto thresholdValue = thresholdRamp.getValue(proportion);
     
-    context.isBypassed = bypassed->get();
+    auto kneeValue =      kneeRamp.getValue(proportion);
     
-    compressor.process(context);
+    // juce::dsp::Compressor always detects per channel
+    auto detectorMode = static_cast<FastCompressorDetectorMode>(detector->getIndex());
     
-    auto postRMS = computeRMSLevel(buffer);
+    auto fast = engine->getIndex() == static_cast<int>(Params::CompressorEngine::Fast);
     
-    auto convertToDb = [](auto input)
+    forEachDsp([&](auto& dsp)
     {
-        return juce::Decibels::gainToDecibels(input);
+        dsp.compressor.setAttack    (attackValue);
+        dsp.compressor.setRelease   (releaseValue);
+        dsp.compressor.setThreshold (thresholdValue);
+        dsp.compressor.setRatio     (ratioValue);
+        
+        dsp.fastCompressor.setAttack    (attackValue);
+        dsp.fastCompressor.setRelease   (releaseValue);
+        dsp.fastCompressor.setThreshold (thresholdValue);
+        dsp.fastCompressor.setRatio     (ratioValue);
+        dsp.fastCompressor.setKnee      (kneeValue);
+        
+        dsp.fastCompressor.setDetectorMode(detectorMode);
+        
+        // the engine taking over starts from a released envelope
+        if( fast != useFastCompressor )
+        {
+            if( fast )
+                dsp.fastCompressor.reset();
+            else
+                dsp.compressor.reset();
+        }
+    });
+    
+    // the settings are where this block's ramps end
+    if( proportion >= 1.f )
+        ramping = false;
+    
+    useFastCompressor = fast;
+    
+    lookaheadSamples = useFastCompressor ? juce::roundToInt(lookahead->get() * 0.001 * sampleRate) : 0;
+    lookaheadSamples = juce::jlimit(0, maxLookaheadSamples, lookaheadSamples);
+}
+
+void CompressorBand::setAlignmentDelay(int delayInSamples)
+{
+    jassert(delayInSamples >= lookaheadSamples && delayInSamples <= maxLookaheadSamples);
+    
+    if( delayInSamples == alignmentDelay )
+        return;
+    
+    // jumping between taps would click, e.g. when lookahead is automated; the
+    // delay lines are fed even at a delay of 0, so there's always a tap to fade from
+    previousAlignmentDelay = alignmentDelay;
+    alignmentFadeRemaining = alignmentFadeSamples;
+    
+    alignmentDelay = delayInSamples;
+}
+
+/*
+ Pushes the block through the delay line and reads it back at two taps:
+ the gain stage gets the signal alignmentDelay samples late, and the detector
+ gets it lookaheadSamples earlier than that. A sidechain goes through its own
+ delay line, and only the detector tap is read from it.
+ 
+ After the delay moved, the gain tap fades linearly from the previous delay
+ to the new one. The detector tap just jumps; the envelope smooths that out.
+ */
+template<typename SampleType>
+void CompressorBand::applyAlignmentDelay(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<const SampleType>& sidechain)
+{
+    auto& dsp = getDsp<SampleType>();
+    
+    auto numChannels = block.getNumChannels();
+    auto numSamples =  block.getNumSamples();
+    auto detectorDelay = static_cast<SampleType>(alignmentDelay - lookaheadSamples);
+    auto gainDelay =     static_cast<SampleType>(alignmentDelay);
+    
+    auto fadeRemaining = static_cast<size_t>(alignmentFadeRemaining);
+    auto fadeDone =      static_cast<size_t>(alignmentFadeSamples - alignmentFadeRemaining);
+    auto fadeStep =      static_cast<SampleType>(1) / static_cast<SampleType>(alignmentFadeSamples);
+    auto previousDelay = static_cast<SampleType>(previousAlignmentDelay);
+    
+    auto popGainTap = [&](int channel, size_t i)
+    {
+        if( i >= fadeRemaining )
+            return dsp.delayLine.popSample(channel, gainDelay);
+        
+        auto previous = dsp.delayLine.popSample(channel, previousDelay, false);
+        auto current =  dsp.delayLine.popSample(channel, gainDelay);
+        return previous + static_cast<SampleType>(fadeDone + i) * fadeStep * (current - previous);
     };
     
-    rmsInputLevelDb.store (convertToDb(preRMS));
-    rmsOutputLevelDb.store(convertToDb(postRMS));
+    for( size_t ch = 0; ch < numChannels; ++ch )
+    {
+        auto channel = static_cast<int>(ch);
+        auto* samples =  block.getChannelPointer(ch);
+        auto* detector = dsp.detectorBuffer.getWritePointer(channel);
+        
+        if( sidechain.getNumChannels() > 0 )
+        {
+            // the key goes in where its delayed version comes out
+            copyKey(sidechain, ch, detector, numSamples);
+            
+            for( size_t i = 0; i < numSamples; ++i )
+            {
+                dsp.sidechainDelayLine.pushSample(channel, detector[i]);
+                detector[i] = dsp.sidechainDelayLine.popSample(channel, detectorDelay);
+                
+                dsp.delayLine.pushSample(channel, samples[i]);
+                samples[i] = popGainTap(channel, i);
+            }
+            
+            continue;
+        }
+        
+        for( size_t i = 0; i < numSamples; ++i )
+        {
+            dsp.delayLine.pushSample(channel, samples[i]);
+            detector[i] = dsp.delayLine.popSample(channel, detectorDelay, false);
+            samples[i] =  popGainTap(channel, i);
+        }
+    }
+    
+    alignmentFadeRemaining -= static_cast<int>(juce::jmin(fadeRemaining, numSamples));
 }
+
+/*
+ With no delay the block passes through untouched, but the delay lines still
+ take every sample, so a delay that is switched on can fade in from tap 0.
+ */
+template<typename SampleType>
+void CompressorBand::feedAlignmentDelay(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<const SampleType>& sidechain)
+{
+    auto& dsp = getDsp<SampleType>();
+    
+    for( size_t ch = 0; ch < block.getNumChannels(); ++ch )
+    {
+        auto channel = static_cast<int>(ch);
+        auto* samples = block.getChannelPointer(ch);
+        
+        for( size_t i = 0; i < block.getNumSamples(); ++i )
+        {
+            dsp.delayLine.pushSample(channel, samples[i]);
+            dsp.delayLine.popSample(channel, static_cast<SampleType>(0));
+        }
+        
+        if( sidechain.getNumChannels() > 0 )
+        {
+            auto* key = dsp.detectorBuffer.getWritePointer(channel);
+            copyKey(sidechain, ch, key, block.getNumSamples());
+            
+            for( size_t i = 0; i < block.getNumSamples(); ++i )
+            {
+                dsp.sidechainDelayLine.pushSample(channel, key[i]);
+                dsp.sidechainDelayLine.popSample(channel, static_cast<SampleType>(0));
+            }
+        }
+    }
+}
+
+CompressorBand::KeySide CompressorBand::getKeySide(juce::AudioChannelSet::ChannelType type)
+{
+    using Set = juce::AudioChannelSet;
+    
+    switch( type )
+    {
+        case Set::left:
+        case Set::leftCentre:
+        case Set::wideLeft:
+        case Set::leftSurround:
+        case Set::leftSurroundSide:
+        case Set::leftSurroundRear:
+        case Set::topFrontLeft:
+        case Set::topRearLeft:
+        case Set::topSideLeft:
+            return KeySide::Left;
+        case Set::right:
+        case Set::rightCentre:
+        case Set::wideRight:
+        case Set::rightSurround:
+        case Set::rightSurroundSide:
+        case Set::rightSurroundRear:
+        case Set::topFrontRight:
+        case Set::topRearRight:
+        case Set::topSideRight:
+            return KeySide::Right;
+        default:
+            return KeySide::Both;
+    }
+}
+
+void CompressorBand::updateKeySides(const juce::AudioChannelSet& layout)
+{
+    keySides.resize(static_cast<size_t>(layout.size()));
+    
+    for( size_t ch = 0; ch < keySides.size(); ++ch )
+        keySides[ch] = getKeySide(layout.getTypeOfChannel(static_cast<int>(ch)));
+}
+
+int CompressorBand::getKeyChannel(size_t channel, size_t numSidechainChannels) const
+{
+    if( numSidechainChannels < 2 )
+        return 0;
+    
+    auto side = channel < keySides.size() ? keySides[channel] : KeySide::Both;
+    
+    switch( side )
+    {
+        case KeySide::Left:  return 0;
+        case KeySide::Right: return 1;
+        case KeySide::Both:  break;
+    }
+    
+    return meanOfKey;
+}
+
+template<typename SampleType>
+void CompressorBand::copyKey(const juce::dsp::AudioBlock<const SampleType>& sidechain,
+                             size_t channel,
+                             SampleType* destination,
+                             size_t numSamples) const
+{
+    auto key = getKeyChannel(channel, sidechain.getNumChannels());
+    
+    if( key != meanOfKey )
+    {
+        juce::FloatVectorOperations::copy(destination, sidechain.getChannelPointer(static_cast<size_t>(key)), static_cast<int>(numSamples));
+        return;
+    }
+    
+    auto* left =  sidechain.getChannelPointer(0);
+    auto* right = sidechain.getChannelPointer(1);
+    
+    for( size_t i = 0; i < numSamples; ++i )
+        destination[i] = (left[i] + right[i]) * static_cast<SampleType>(0.5);
+}
+
+/*
+ A sidechain whose channels already line up with the band's is used in
+ place. Otherwise the key of every channel is put together in the detector
+ buffer.
+ */
+template<typename SampleType>
+juce::dsp::AudioBlock<const SampleType> CompressorBand::getSidechainBlock(const juce::dsp::AudioBlock<const SampleType>& sidechain,
+                                                                          size_t numChannels,
+                                                                          size_t numSamples)
+{
+    auto& detectorBuffer = getDsp<SampleType>().detectorBuffer;
+    
+    auto sidechainChannels = sidechain.getNumChannels();
+    jassert(sidechainChannels > 0);
+    
+    auto inPlace = sidechainChannels >= numChannels;
+    for( size_t ch = 0; ch < numChannels && inPlace; ++ch )
+        inPlace = getKeyChannel(ch, sidechainChannels) == static_cast<int>(ch);
+    
+    if( inPlace )
+    {
+        return sidechain.getSubsetChannelBlock(0, numChannels)
+                        .getSubBlock(0, numSamples);
+    }
+    
+    for( size_t ch = 0; ch < numChannels; ++ch )
+        copyKey(sidechain, ch, detectorBuffer.getWritePointer(static_cast<int>(ch)), numSamples);
+    
+    return juce::dsp::AudioBlock<const SampleType>(detectorBuffer)
+            .getSubsetChannelBlock(0, numChannels)
+            .getSubBlock(0, numSamples);
+}
+
+template<typename SampleType>
+void CompressorBand::process(const juce::dsp::AudioBlock<SampleType>& block,
+                             const juce::dsp::AudioBlock<const SampleType>& sidechain)
+{
+    auto numChannels = block.getNumChannels();
+    auto numSamples =  block.getNumSamples();
+    
+    if( isDelaying() )
+        applyAlignmentDelay(block, sidechain);
+    else
+        feedAlignmentDelay(block, sidechain);
+    
+    auto isBypassed = bypassed->get();
+    
+    // the fast engine can be keyed from something other than the band itself
+    auto detectorBlock = juce::dsp::AudioBlock<const SampleType>(block);
+    if( ! isBypassed && useFastCompressor )
+    {
+        if( isDelaying() )
+        {
+            detectorBlock = juce::dsp::AudioBlock<const SampleType>(getDsp<SampleType>().detectorBuffer)
+                                .getSubsetChannelBlock(0, numChannels)
+                                .getSubBlock(0, numSamples);
+        }
+        else if( sidechain.getNumChannels() > 0 )
+        {
+            detectorBlock = getSidechainBlock(sidechain, numChannels, numSamples);
+        }
+    }
+    
+    blockLevels.clear();
+    
+    // the block is split where history frames end, so each frame is metered
+    // over exactly its own samples
+    for( size_t start = 0; start < numSamples; )
+    {
+        auto num = juce::jmin(numSamples - start, static_cast<size_t>(samplesUntilFrame));
+        auto subBlock = block.getSubBlock(start, num);
+        
+        const auto& subBlockLevels = isBypassed ? measureBypassed(subBlock)
+                                                : compress(subBlock, detectorBlock.getSubBlock(start, num));
+        
+        blockLevels.add(subBlockLevels);
+        advanceHistory(num, subBlockLevels);
+        
+        start += num;
+    }
+    
+    meter.store(blockLevels.getReading());
+}
+
+void CompressorBand::skip(int numSamples)
+{
+    auto remaining = static_cast<size_t>(numSamples);
+    
+    while( remaining > 0 )
+    {
+        auto num = juce::jmin(remaining, static_cast<size_t>(samplesUntilFrame));
+        advanceHistory(num, silence);
+        remaining -= num;
+    }
+}
+
+template<typename SampleType>
+const LevelAccumulator& CompressorBand::compress(juce::dsp::AudioBlock<SampleType>& block,
+                                                 const juce::dsp::AudioBlock<const SampleType>& detectorBlock)
+{
+    auto& dsp = getDsp<SampleType>();
+    
+    auto context = juce::dsp::ProcessContextReplacing<SampleType>(block);
+    
+    if( useFastCompressor )
+    {
+        dsp.fastCompressor.process(context, detectorBlock);
+        return dsp.fastCompressor.getLevels();
+    }
+    
+    // juce::dsp::Compressor can't be metered from the inside, so it's measured
+    // on either side of it
+    levels.clear();
+    for( size_t ch = 0; ch < block.getNumChannels(); ++ch )
+    {
+        levels.addInput(block.getChannelPointer(ch), block.getNumSamples());
+    }
+    
+    dsp.compressor.process(context);
+    
+    for( size_t ch = 0; ch < block.getNumChannels(); ++ch )
+    {
+        levels.addOutput(block.getChannelPointer(ch), block.getNumSamples());
+    }
+    
+    return levels;
+}
+
+// nothing to compress, the band only had to stay aligned with the others
+template<typename SampleType>
+const LevelAccumulator& CompressorBand::measureBypassed(const juce::dsp::AudioBlock<SampleType>& block)
+{
+    levels.clear();
+    for( size_t ch = 0; ch < block.getNumChannels(); ++ch )
+    {
+        levels.addInput(block.getChannelPointer(ch), block.getNumSamples());
+    }
+    
+    levels.copyInputToOutput();
+    return levels;
+}
+
+void CompressorBand::advanceHistory(size_t numSamples, const LevelAccumulator& subBlockLevels)
+{
+    jassert(numSamples <= static_cast<size_t>(samplesUntilFrame));
+    
+    frameLevels.add(subBlockLevels);
+    samplesUntilFrame -= static_cast<int>(numSamples);
+    
+    if( samplesUntilFrame == 0 )
+    {
+        // if the ring is full the GUI isn't draining it, and the frame is dropped
+        history.push(frameLevels.getReading());
+        
+        frameLevels.clear();
+        samplesUntilFrame = historyFrameSamples;
+    }
+}
+
+//==============================================================================
+template void CompressorBand::process<float> (const juce::dsp::AudioBlock<float>&,  const juce::dsp::AudioBlock<const float>&);
+template void CompressorBand::process<double>(const juce::dsp::AudioBlock<double>&, const juce::dsp::AudioBlock<const double>&);
@@ -12,6 +12,13 @@
 
 #include <JuceHeader.h>
 #include "../GUI/Utilities.h"
+#include "FastCompressor.h"
+#include "Fifo.h"
+#include "LevelMeter.h"
+#include "ParameterGroup.h"
+#include "RampedParameter.h"
+#include "SeqLock.h"
+#include <type_traits>
 
 struct CompressorBand
 {
@@ -22,33 +29,195 @@ struct CompressorBand
     juce::AudioParameterBool*   bypassed  { nullptr };
     juce::AudioParameterBool*   mute      { nullptr };
     juce::AudioParameterBool*   solo      { nullptr };
+    juce::AudioParameterFloat*  knee      { nullptr };
+    juce::AudioParameterChoice* engine    { nullptr };
+    juce::AudioParameterFloat*  lookahead { nullptr };
+    juce::AudioParameterChoice* detector  { nullptr };
+    
+    // call once the parameter pointers above have been set
+    void listenForSettingsChanges();
     
     void prepare(const juce::dsp::ProcessSpec& spec);
     
-    void updateCompressorSettings();
+    // the main bus layout, which the Linked Groups detector reads; call after prepare()
+    void setChannelLayout(const juce::AudioChannelSet& layout);
     
-    void process(juce::AudioBuffer<float>& buffer);
+    /*
+     Clears the envelopes, the lookahead history and the meters. The processor
+     calls this when it stops processing a band that can't be heard, so the band
+     starts from silence when it comes back. Safe to call from the audio thread.
+     */
+    void reset();
     
-    float getRMSOutputLevelDb() const { return rmsOutputLevelDb; }
-    float getRMSInputLevelDb () const { return rmsInputLevelDb; }
-private:
-    juce::dsp::Compressor<float> compressor;
+    /*
+     Attack, release, threshold and knee follow host automation within a
+     block. beginAutomation() starts their ramps at the top of a host block
+     and says whether the settings still have to follow them.
+     updateCompressorSettings() then computes the settings proportion of the
+     way through that block; with followRamps off it only does so when a
+     parameter changed. The ramps count as followed once the settings have
+     been computed at a proportion of 1.
+     */
+    bool beginAutomation() noexcept;
+    
+    void updateCompressorSettings(float proportion = 1.f, bool followRamps = false);
+    
+    juce::uint64 getNumSkippedUpdates() const { return settings.getNumSkippedUpdates(); }
+    
+    /*
+     Lookahead needs the detector to run ahead of the gain stage, which only the
+     fast engine supports, so the classic engine always reports 0.
+     */
+    int getLookaheadSamples() const { return lookaheadSamples; }
+    
+    /*
+     Every band has to be delayed by the largest lookahead of all bands to stay
+     aligned with the others. Must not exceed the maximum lookahead, and never
+     allocates, so it is safe to call from the audio thread. Every change,
+     switching the delay on or off included, crossfades from the old tap to
+     the new one over alignmentFadeSeconds.
+     */
+    void setAlignmentDelay(int delayInSamples);
+    
+    /*
+     Processes block in place. It can be any range of samples up to the
+     prepared block size, and any number of channels up to the prepared
+     count; channel i of the block is always the band's channel i.
+     
+     With a sidechain, the detector is keyed from this band of the sidechain
+     instead of the band itself, and an empty sidechain block means there is
+     none. A stereo sidechain is mapped onto the band's channels by their
+     positions in the layout, see KeySide. Only the fast engine has a
+     separate detector input, so the classic engine ignores it.
+     
+     SampleType is float or double. Each has its own engines, delay lines and
+     envelopes, which share the settings but not their state.
+     */
+    template<typename SampleType>
+    void process(const juce::dsp::AudioBlock<SampleType>& block,
+                 const juce::dsp::AudioBlock<const SampleType>& sidechain = {});
+    
+    /*
+     Stands in for process() while the processor leaves the band out, so its
+     history keeps time with the other bands. Pushes silent frames.
+     */
+    void skip(int numSamples);
+    
+    // the meters of the last processed block, safe to call from any thread
+    MeterReading getMeterReading() const { return meter.load(); }
     
-    std::atomic<float> rmsInputLevelDb  { NEGATIVE_INFINITY };
-    std::atomic<float> rmsOutputLevelDb { NEGATIVE_INFINITY };
+    /*
+     Meter readings for every historyFrameSeconds of audio, oldest first. The
+     audio thread pushes them without blocking. The processor's
+     updateMeterHistory() is the only consumer; everything else reads the
+     processor's getMeterHistory() instead of pulling from here.
+     */
+    static constexpr double historyFrameSeconds = 0.005;
+    static constexpr int historySize = 1024;
     
-    template<typename T>
-    float computeRMSLevel(const T& buffer)
+    bool pullHistoryFrame(MeterReading& frame) { return history.pull(frame); }
+private:
+    template<typename SampleType>
+    struct Dsp
     {
-        int numChannels = static_cast<int>(buffer.getNumChannels());
-        int numSamples =  static_cast<int>(buffer.getNumSamples());
-        auto rms = 0.f;
-        for( int chan = 0; chan < numChannels; ++chan )
-        {
-            rms += buffer.getRMSLevel(chan, 0, numSamples);
-        }
+        juce::dsp::Compressor<SampleType> compressor;
+        FastCompressor<SampleType>        fastCompressor;
         
-        rms /= static_cast<float>(numChannels);
-        return rms;
+        juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> delayLine, sidechainDelayLine;
+        juce::AudioBuffer<SampleType> detectorBuffer;
+    };
+    
+    Dsp<float>  floatDsp;
+    Dsp<double> doubleDsp;
+    
+    template<typename SampleType>
+    Dsp<SampleType>& getDsp()
+    {
+        if constexpr( std::is_same_v<SampleType, double> )
+            return doubleDsp;
+        else
+            return floatDsp;
     }
+    
+    template<typename Function>
+    void forEachDsp(Function&& function)
+    {
+        function(floatDsp);
+        function(doubleDsp);
+    }
+    
+    bool useFastCompressor { false };
+    
+    double sampleRate { 44100.0 };
+    int maxLookaheadSamples { 0 };
+    int lookaheadSamples { 0 };
+    int alignmentDelay { 0 };
+    
+    static constexpr double alignmentFadeSeconds = 0.005;
+    int alignmentFadeSamples { 1 };
+    int alignmentFadeRemaining { 0 };
+    int previousAlignmentDelay { 0 };
+    
+    // the taps are read while a delay is set, and while fading into or out of one
+    bool isDelaying() const { return alignmentDelay > 0 || alignmentFadeRemaining > 0; }
+    
+    template<typename SampleType>
+    void applyAlignmentDelay(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<const SampleType>& sidechain);
+    
+    template<typename SampleType>
+    void feedAlignmentDelay(const juce::dsp::AudioBlock<SampleType>& block, const juce::dsp::AudioBlock<const SampleType>& sidechain);
+    
+    /*
+     A mono key keys every channel. A stereo key is mapped by where the band's
+     channels sit in the layout: left side speakers are keyed from its left,
+     right side speakers from its right, and centres, LFEs and anything else
+     without a side from the mean of both.
+     */
+    enum class KeySide
+    {
+        Left,
+        Right,
+        Both
+    };
+    
+    std::vector<KeySide> keySides;
+    
+    static KeySide getKeySide(juce::AudioChannelSet::ChannelType type);
+    void updateKeySides(const juce::AudioChannelSet& layout);
+    
+    // the sidechain channel that keys channel, or meanOfKey
+    static constexpr int meanOfKey = -1;
+    int getKeyChannel(size_t channel, size_t numSidechainChannels) const;
+    
+    template<typename SampleType>
+    void copyKey(const juce::dsp::AudioBlock<const SampleType>& sidechain, size_t channel, SampleType* destination, size_t numSamples) const;
+    
+    template<typename SampleType>
+    juce::dsp::AudioBlock<const SampleType> getSidechainBlock(const juce::dsp::AudioBlock<const SampleType>& sidechain,
+                                                              size_t numChannels,
+                                                              size_t numSamples);
+    
+    ParameterGroup settings;
+    RampedParameter attackRamp, releaseRamp, thresholdRamp, kneeRamp;
+    bool ramping { false };
+    
+    // the fast engine meters itself, this is for bypass and the classic engine
+    LevelAccumulator levels;
+    LevelAccumulator blockLevels, frameLevels;
+    const LevelAccumulator silence;
+    
+    SeqLock<MeterReading> meter;
+    
+    int historyFrameSamples { 1 };
+    int samplesUntilFrame { 1 };
+    Fifo<MeterReading, historySize> history;
+    
+    template<typename SampleType>
+    const LevelAccumulator& compress(juce::dsp::AudioBlock<SampleType>& block,
+                                     const juce::dsp::AudioBlock<const SampleType>& detectorBlock);
+    
+    template<typename SampleType>
+    const LevelAccumulator& measureBypassed(const juce::dsp::AudioBlock<SampleType>& block);
+    
+    void advanceHistory(size_t numSamples, const LevelAccumulator& subBlockLevels);
 };
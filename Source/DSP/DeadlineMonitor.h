@@ -0,0 +1,156 @@
+/*
+ ==============================================================================
+ 
+ DeadlineMonitor.h
+ Created: 12 Oct 2026 9:41:18am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/*
+ Load is the time a processBlock call took over the time its samples last,
+ numSamples / sampleRate. At 1 the block missed its deadline, and from
+ nearMissLoad on it came close enough that a busier machine would have.
+ */
+struct DeadlineStats
+{
+    static constexpr int numBins = 31;  // 5 % each, the last one is 150 % and up
+    static constexpr float binWidth = 0.05f;
+    static constexpr float nearMissLoad = 0.8f;
+    
+    std::array<juce::uint64, numBins> histogram {};
+    juce::uint64 numBlocks { 0 }, numNearMisses { 0 }, numMisses { 0 };
+    float averageLoad { 0.f };
+    float worstLoad { 0.f };
+    
+    static int getBin(float load)
+    {
+        return juce::jlimit(0, numBins - 1, static_cast<int>(load / binWidth));
+    }
+};
+
+//==============================================================================
+/*
+ Times every processBlock call against its budget, cheaply enough to stay on
+ in production: two clock reads and a few relaxed atomic adds per block.
+ 
+ Only the audio thread writes the counters, so any thread can read them
+ without locking; a reading may be a block behind in places. reset() is
+ carried out by the audio thread on its next block.
+ */
+struct DeadlineMonitor
+{
+    void prepare(double sampleRate)
+    {
+        ticksPerSample = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / sampleRate;
+    }
+    
+    struct ScopedBlock
+    {
+        ScopedBlock(DeadlineMonitor& monitorToUse, int numSamplesInBlock, bool shouldMeasure = true) noexcept
+            : monitor(shouldMeasure ? &monitorToUse : nullptr),
+              numSamples(numSamplesInBlock),
+              startTicks(monitor != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+        
+        ~ScopedBlock()
+        {
+            if( monitor != nullptr )
+                monitor->add(numSamples, juce::Time::getHighResolutionTicks() - startTicks);
+        }
+    private:
+        DeadlineMonitor* monitor;
+        int numSamples;
+        juce::int64 startTicks;
+    };
+    
+    // audio thread
+    void add(int numSamples, juce::int64 ticks) noexcept
+    {
+        if( numSamples <= 0 )
+            return;
+        
+        if( resetRequested.exchange(false) )
+            clear();
+        
+        auto budget = static_cast<juce::int64>(numSamples * ticksPerSample);
+        auto load = static_cast<float>(ticks) / static_cast<float>(juce::jmax(budget, juce::int64(1)));
+        
+        increment(histogram[static_cast<size_t>(DeadlineStats::getBin(load))]);
+        increment(numBlocks);
+        
+        if( load >= 1.f )
+            increment(numMisses);
+        else if( load >= DeadlineStats::nearMissLoad )
+            increment(numNearMisses);
+        
+        totalTicks.store(totalTicks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+        totalBudget.store(totalBudget.load(std::memory_order_relaxed) + budget, std::memory_order_relaxed);
+        
+        if( load > worstLoad.load(std::memory_order_relaxed) )
+            worstLoad.store(load, std::memory_order_relaxed);
+        
+        if( load > peakLoad.load(std::memory_order_relaxed) )
+            peakLoad.store(load, std::memory_order_relaxed);
+    }
+    
+    // any thread
+    DeadlineStats getStats() const
+    {
+        DeadlineStats stats;
+        
+        for( size_t bin = 0; bin < stats.histogram.size(); ++bin )
+            stats.histogram[bin] = histogram[bin].load(std::memory_order_relaxed);
+        
+        stats.numBlocks =     numBlocks.load(std::memory_order_relaxed);
+        stats.numNearMisses = numNearMisses.load(std::memory_order_relaxed);
+        stats.numMisses =     numMisses.load(std::memory_order_relaxed);
+        stats.worstLoad =     worstLoad.load(std::memory_order_relaxed);
+        
+        auto budget = totalBudget.load(std::memory_order_relaxed);
+        stats.averageLoad = budget > 0 ? static_cast<float>(static_cast<double>(totalTicks.load(std::memory_order_relaxed)) / static_cast<double>(budget))
+                                       : 0.f;
+        return stats;
+    }
+    
+    // the worst load since the last call, for a meter; only one reader should use it
+    float takePeakLoad() { return peakLoad.exchange(0.f); }
+    
+    void reset() { resetRequested.store(true); }
+private:
+    std::array<std::atomic<juce::uint64>, DeadlineStats::numBins> histogram {};
+    std::atomic<juce::uint64> numBlocks { 0 }, numNearMisses { 0 }, numMisses { 0 };
+    std::atomic<juce::int64> totalTicks { 0 }, totalBudget { 0 };
+    std::atomic<float> worstLoad { 0.f }, peakLoad { 0.f };
+    std::atomic<bool> resetRequested { false };
+    
+    double ticksPerSample { 1.0 };
+    
+    // single writer, so there's no need for a locked read-modify-write
+    static void increment(std::atomic<juce::uint64>& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    
+    void clear() noexcept
+    {
+        for( auto& bin : histogram )
+            bin.store(0, std::memory_order_relaxed);
+        
+        numBlocks.store(0, std::memory_order_relaxed);
+        numNearMisses.store(0, std::memory_order_relaxed);
+        numMisses.store(0, std::memory_order_relaxed);
+        totalTicks.store(0, std::memory_order_relaxed);
+        totalBudget.store(0, std::memory_order_relaxed);
+        worstLoad.store(0.f, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,483 @@
+/*
+ ==============================================================================
+ 
+ FastCompressor.cpp
+ Created: 5 Oct 2026 11:02:18am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "FastCompressor.h"
+#include "FastMath.h"
+
+namespace
+{
+// dB = 20 * log10(x) = dbPerOctave * log2(x)
+constexpr double dbPerOctave = 6.020599913279624;
+constexpr double octavesPerDb = 1.0 / dbPerOctave;
+
+// -200 dB...+120 dB keeps log2 away from zero and exp2 inside its range
+constexpr double minimumLevel = 1.0e-10;
+constexpr double maximumLevel = 1.0e6;
+
+// same as juce::dsp::BallisticsFilter::calculateLimitedCte()
+template<typename SampleType>
+SampleType calculateCoefficient(double sampleRate, float timeMs)
+{
+    return timeMs < 1.0e-3f ? SampleType(0)
+                            : static_cast<SampleType>(std::exp(-juce::MathConstants<double>::twoPi * 1000.0
+                                                               / (sampleRate * static_cast<double>(timeMs))));
+}
+
+// the double compressor trades FastMath's speed for the precision it was asked for
+inline float  getLog2(float x)  noexcept { return FastMath::log2(x); }
+inline float  getExp2(float x)  noexcept { return FastMath::exp2(x); }
+inline double getLog2(double x) noexcept { return std::log2(x); }
+inline double getExp2(double x) noexcept { return std::exp2(x); }
+
+// what LinkedGroups links a channel with
+enum class Position
+{
+    Front,
+    Surround,
+    Height,
+    Separate
+};
+
+Position getPosition(juce::AudioChannelSet::ChannelType type)
+{
+    using Set = juce::AudioChannelSet;
+    
+    switch( type )
+    {
+        case Set::left:
+        case Set::right:
+        case Set::centre:
+        case Set::leftCentre:
+        case Set::rightCentre:
+        case Set::wideLeft:
+        case Set::wideRight:
+            return Position::Front;
+        case Set::leftSurround:
+        case Set::rightSurround:
+        case Set::centreSurround:
+        case Set::leftSurroundSide:
+        case Set::rightSurroundSide:
+        case Set::leftSurroundRear:
+        case Set::rightSurroundRear:
+            return Position::Surround;
+        case Set::topMiddle:
+        case Set::topFrontLeft:
+        case Set::topFrontCentre:
+        case Set::topFrontRight:
+        case Set::topRearLeft:
+        case Set::topRearCentre:
+        case Set::topRearRight:
+        case Set::topSideLeft:
+        case Set::topSideRight:
+            return Position::Height;
+        default:
+            return Position::Separate;
+    }
+}
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.sampleRate > 0);
+    jassert(spec.numChannels > 0);
+    
+    sampleRate = spec.sampleRate;
+    
+    detectorChannels.assign(spec.numChannels, nullptr);
+    inputChannels.assign   (spec.numChannels, nullptr);
+    outputChannels.assign  (spec.numChannels, nullptr);
+    
+    // at most a group per channel, and mid/side always takes two
+    auto maxGroups = juce::jmax(static_cast<size_t>(spec.numChannels), size_t(2));
+    auto numRegisters = (maxGroups + Register::size() - 1) / Register::size();
+    
+    envelopeState.assign(numRegisters,             Register::expand(SampleType(0)));
+    envelopeLanes.assign(numRegisters * chunkSize, Register::expand(SampleType(0)));
+    
+    gains.assign(maxGroups * chunkSize, SampleType(0));
+    knee.assign (maxGroups * chunkSize, SampleType(0));
+    
+    channelGroups.assign(spec.numChannels, 0);
+    groupSizes.assign   (spec.numChannels, 0);
+    firstInGroup.assign (spec.numChannels, false);
+    
+    setChannelLayout(juce::AudioChannelSet::canonicalChannelSet(static_cast<int>(spec.numChannels)));
+    
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::reset()
+{
+    std::fill(envelopeState.begin(), envelopeState.end(), Register::expand(SampleType(0)));
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setThreshold(float newThresholdDb)
+{
+    thresholdDb = newThresholdDb;
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setRatio(float newRatio)
+{
+    jassert(newRatio >= 1.f);
+    
+    ratio = newRatio;
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setAttack(float newAttackMs)
+{
+    attackMs = newAttackMs;
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setRelease(float newReleaseMs)
+{
+    releaseMs = newReleaseMs;
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setKnee(float newKneeDb)
+{
+    jassert(newKneeDb >= 0.f);
+    
+    kneeDb = newKneeDb;
+    update();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setDetectorMode(DetectorMode newMode)
+{
+    if( newMode == detectorMode )
+        return;
+    
+    // the envelopes track different signals in each mode
+    detectorMode = newMode;
+    updateGroups(numMappedChannels);
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::setChannelLayout(const juce::AudioChannelSet& newLayout)
+{
+    jassert(static_cast<size_t>(newLayout.size()) >= channelGroups.size());
+    
+    channelPositions.resize(channelGroups.size());
+    
+    for( size_t ch = 0; ch < channelPositions.size(); ++ch )
+    {
+        auto position = getPosition(newLayout.getTypeOfChannel(static_cast<int>(ch)));
+        channelPositions[ch] = position == Position::Separate ? static_cast<int>(Position::Separate) + static_cast<int>(ch)
+                                                              : static_cast<int>(position);
+    }
+    
+    updateGroups(channelGroups.size());
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::update()
+{
+    attackCoefficient =  calculateCoefficient<SampleType>(sampleRate, attackMs);
+    releaseCoefficient = calculateCoefficient<SampleType>(sampleRate, releaseMs);
+    
+    auto kneeWidth = static_cast<SampleType>(kneeDb);
+    
+    slope =     SampleType(1) / static_cast<SampleType>(ratio) - SampleType(1);
+    halfKnee =  kneeWidth * SampleType(0.5);
+    kneeScale = kneeWidth > 0 ? SampleType(1) / (SampleType(2) * kneeWidth) : SampleType(0);
+}
+
+/*
+ Rebuilt whenever the mode, the layout or the number of channels in a block
+ changes. Groups are numbered in the order their first channel appears, so
+ Unlinked gives every channel the group of the same number.
+ */
+template<typename SampleType>
+void FastCompressor<SampleType>::updateGroups(size_t numChannels) noexcept
+{
+    jassert(numChannels <= channelGroups.size());
+    
+    numGroups = 0;
+    
+    for( size_t ch = 0; ch < numChannels; ++ch )
+    {
+        auto group = numGroups;
+        
+        switch( detectorMode )
+        {
+            case DetectorMode::LinkedMax:
+            case DetectorMode::LinkedMean:
+                group = 0;
+                break;
+            case DetectorMode::LinkedGroups:
+                for( size_t other = 0; other < ch; ++other )
+                {
+                    if( channelPositions[other] == channelPositions[ch] )
+                    {
+                        group = channelGroups[other];
+                        break;
+                    }
+                }
+                break;
+            case DetectorMode::Unlinked:
+            case DetectorMode::MidSide:
+                break;
+        }
+        
+        firstInGroup[ch] = group == numGroups;
+        
+        if( firstInGroup[ch] )
+            groupSizes[numGroups++] = 0;
+        
+        channelGroups[ch] = group;
+        ++groupSizes[group];
+    }
+    
+    numMappedChannels = numChannels;
+    
+    // the envelopes belonged to other groups
+    reset();
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::processChannels(size_t numChannels, size_t numSamples) noexcept
+{
+    auto midSide = detectorMode == DetectorMode::MidSide && numChannels == 2;
+    
+    if( ! midSide && numChannels != numMappedChannels )
+        updateGroups(numChannels);
+    
+    auto groups = midSide ? size_t(2) : numGroups;
+    
+    for( size_t start = 0; start < numSamples; start += chunkSize )
+    {
+        auto num = juce::jmin(chunkSize, numSamples - start);
+        
+        if( midSide )
+            gatherMidSide(start, num);
+        else
+            gatherGroups(numChannels, start, num);
+        
+        followEnvelopes(groups, num);
+        computeGains(gains.data(), groups * num);
+        
+        levels.addGains(gains.data(), groups * num);
+        
+        if( midSide )
+            applyMidSide(start, num);
+        else
+            applyGroups(numChannels, start, num);
+    }
+    
+    auto* state = getLanes(envelopeState);
+    
+    for( size_t group = 0; group < groups; ++group )
+        juce::dsp::util::snapToZero(state[group]);
+}
+
+// the detector level of every group, packed into gains numSamples apart
+template<typename SampleType>
+void FastCompressor<SampleType>::gatherGroups(size_t numChannels, size_t start, size_t numSamples) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+    auto n = static_cast<int>(numSamples);
+    
+    auto mean = detectorMode == DetectorMode::LinkedMean;
+    
+    for( size_t ch = 0; ch < numChannels; ++ch )
+    {
+        auto* level = gains.data() + channelGroups[ch] * numSamples;
+        
+        if( firstInGroup[ch] )
+        {
+            FVO::abs(level, detectorChannels[ch] + start, n);
+            continue;
+        }
+        
+        FVO::abs(scratch.data(), detectorChannels[ch] + start, n);
+        
+        if( mean )
+            FVO::add(level, scratch.data(), n);
+        else
+            FVO::max(level, level, scratch.data(), n);
+    }
+    
+    if( ! mean )
+        return;
+    
+    for( size_t group = 0; group < numGroups; ++group )
+    {
+        if( groupSizes[group] > 1 )
+            FVO::multiply(gains.data() + group * numSamples, SampleType(1) / static_cast<SampleType>(groupSizes[group]), n);
+    }
+}
+
+// mid = (L + R) / 2 and side = (L - R) / 2, for the detector and the audio
+template<typename SampleType>
+void FastCompressor<SampleType>::gatherMidSide(size_t start, size_t numSamples) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+    auto n = static_cast<int>(numSamples);
+    
+    auto* midLevel =  gains.data();
+    auto* sideLevel = gains.data() + numSamples;
+    
+    FVO::add     (midLevel,  detectorChannels[0] + start, detectorChannels[1] + start, n);
+    FVO::subtract(sideLevel, detectorChannels[0] + start, detectorChannels[1] + start, n);
+    FVO::multiply(midLevel,  SampleType(0.5), n);
+    FVO::multiply(sideLevel, SampleType(0.5), n);
+    FVO::abs     (midLevel,  midLevel,  n);
+    FVO::abs     (sideLevel, sideLevel, n);
+    
+    levels.addInput(inputChannels[0] + start, numSamples);
+    levels.addInput(inputChannels[1] + start, numSamples);
+    
+    FVO::add     (mid.data(),  inputChannels[0] + start, inputChannels[1] + start, n);
+    FVO::subtract(side.data(), inputChannels[0] + start, inputChannels[1] + start, n);
+    FVO::multiply(mid.data(),  SampleType(0.5), n);
+    FVO::multiply(side.data(), SampleType(0.5), n);
+}
+
+template<typename SampleType>
+void FastCompressor<SampleType>::applyGroups(size_t numChannels, size_t start, size_t numSamples) noexcept
+{
+    for( size_t ch = 0; ch < numChannels; ++ch )
+    {
+        levels.addInput(inputChannels[ch] + start, numSamples);
+        
+        juce::FloatVectorOperations::multiply(outputChannels[ch] + start,
+                                              inputChannels[ch] + start,
+                                              gains.data() + channelGroups[ch] * numSamples,
+                                              static_cast<int>(numSamples));
+        
+        levels.addOutput(outputChannels[ch] + start, numSamples);
+    }
+}
+
+// L = mid + side, R = mid - side
+template<typename SampleType>
+void FastCompressor<SampleType>::applyMidSide(size_t start, size_t numSamples) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+    auto n = static_cast<int>(numSamples);
+    
+    FVO::multiply(mid.data(),  gains.data(),              n);
+    FVO::multiply(side.data(), gains.data() + numSamples, n);
+    
+    FVO::add     (outputChannels[0] + start, mid.data(), side.data(), n);
+    FVO::subtract(outputChannels[1] + start, mid.data(), side.data(), n);
+    
+    levels.addOutput(outputChannels[0] + start, numSamples);
+    levels.addOutput(outputChannels[1] + start, numSamples);
+}
+
+/*
+ Peak ballistics, same as juce::dsp::BallisticsFilter, for every group at
+ once. The levels are moved into the groups' lanes, followed, and moved back
+ as the envelopes.
+ */
+template<typename SampleType>
+void FastCompressor<SampleType>::followEnvelopes(size_t groups, size_t numSamples) noexcept
+{
+    constexpr auto width = Register::size();
+    auto numRegisters = (groups + width - 1) / width;
+    
+    auto* lanes = getLanes(envelopeLanes);
+    
+    for( size_t group = 0; group < groups; ++group )
+    {
+        auto* level = gains.data() + group * numSamples;
+        auto* lane =  lanes + (group / width) * chunkSize * width + group % width;
+        
+        for( size_t i = 0; i < numSamples; ++i )
+            lane[i * width] = level[i];
+    }
+    
+    auto release =            Register::expand(releaseCoefficient);
+    auto attackMinusRelease = Register::expand(attackCoefficient - releaseCoefficient);
+    
+    for( size_t r = 0; r < numRegisters; ++r )
+    {
+        auto state = envelopeState[r];
+        auto* envelope = envelopeLanes.data() + r * chunkSize;
+        
+        for( size_t i = 0; i < numSamples; ++i )
+        {
+            auto level = envelope[i];
+            auto coefficient = release + (attackMinusRelease & Register::greaterThan(level, state));
+            state = level + coefficient * (state - level);
+            envelope[i] = state;
+        }
+        
+        envelopeState[r] = state;
+    }
+    
+    for( size_t group = 0; group < groups; ++group )
+    {
+        auto* level = gains.data() + group * numSamples;
+        auto* lane =  lanes + (group / width) * chunkSize * width + group % width;
+        
+        for( size_t i = 0; i < numSamples; ++i )
+            level[i] = lane[i * width];
+    }
+}
+
+/*
+ Replaces each envelope level with the gain to apply to it.
+ 
+ Below the knee the gain is 0 dB, above it the level is pulled towards the
+ threshold by the ratio, and inside the knee the gain reduction follows the
+ usual quadratic so the two meet smoothly. With over = level - threshold:
+    reduction = slope * (over + knee/2)^2 / (2 knee)    for |over| < knee/2
+    reduction = slope * over                             for over >= knee/2
+ 
+ Both pieces come out of one branch free expression,
+    (clip(over, -knee/2, knee/2) + knee/2)^2 / (2 knee) + max(over - knee/2, 0)
+ which also reduces to max(over, 0) for a hard knee.
+ */
+template<typename SampleType>
+void FastCompressor<SampleType>::computeGains(SampleType* levels, size_t numSamples) noexcept
+{
+    using FVO = juce::FloatVectorOperations;
+    auto num = static_cast<int>(numSamples);
+    
+    constexpr auto dbScale =     static_cast<SampleType>(dbPerOctave);
+    constexpr auto octaveScale = static_cast<SampleType>(octavesPerDb);
+    auto threshold = static_cast<SampleType>(thresholdDb);
+    
+    FVO::clip(levels, levels, static_cast<SampleType>(minimumLevel), static_cast<SampleType>(maximumLevel), num);
+    
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        levels[i] = dbScale * getLog2(levels[i]) - threshold;
+    }
+    
+    FVO::clip(knee.data(), levels, -halfKnee, halfKnee, num);
+    FVO::add (levels, -halfKnee, num);
+    FVO::max (levels, levels, SampleType(0), num);
+    
+    for( size_t i = 0; i < numSamples; ++i )
+    {
+        auto kneeInput = knee[i] + halfKnee;
+        auto effectiveOver = kneeInput * kneeInput * kneeScale + levels[i];
+        
+        levels[i] = getExp2(slope * effectiveOver * octaveScale);
+    }
+}
+
+//==============================================================================
+template struct FastCompressor<float>;
+template struct FastCompressor<double>;
@@ -0,0 +1,195 @@
+/*
+ ==============================================================================
+ 
+ FastCompressor.h
+ Created: 5 Oct 2026 11:02:18am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "LevelMeter.h"
+
+//==============================================================================
+/*
+ Drop-in alternative to juce::dsp::Compressor with a soft knee.
+ 
+ The peak detector uses the same ballistics as juce::dsp::BallisticsFilter, so
+ with a 0 dB knee the transfer curve is the same as the JUCE compressor's.
+ 
+ The channels are gathered into detector groups, each with one envelope and
+ one gain curve that is applied to all of its channels. The work is split in
+ passes over chunks of chunkSize samples:
+    1. the detector level of every group, the max or mean of its channels
+    2. the envelope follower, which is recursive in time but independent
+       across groups, so the groups run side by side in the lanes of
+       juce::dsp::SIMDRegister and a surround bus fills them
+    3. the gain computer, which works in the log domain with FastMath::log2 and
+       FastMath::exp2. It has no loop carried state and is written as a few
+       branch free passes, with the clamps done by FloatVectorOperations, so
+       every pass runs in SIMD over all groups at once.
+ 
+ The detector can be fed from a different block than the one being
+ compressed, which is how CompressorBand implements lookahead.
+ 
+ Detector modes:
+    Unlinked:   every channel has its own envelope and gain, like JUCE's
+    LinkedMax:  one envelope follows the loudest channel, and the one gain
+                curve is applied to every channel, so the image doesn't shift
+    LinkedMean: the same with the mean of the channel levels
+    MidSide:    a stereo pair is compressed as mid and side, each with its own
+                envelope, and converted back to left/right afterwards
+    LinkedGroups: the channels of the layout are linked by where they sit,
+                fronts with fronts, surrounds with surrounds and heights with
+                heights, like LinkedMax within each group. Every LFE, and any
+                channel without a known position, is a group of its own.
+ MidSide needs exactly two channels and is unlinked otherwise.
+ 
+ Input and output levels and the applied gains are metered chunk by chunk in
+ the same loop, see getLevels().
+ 
+ Like juce::dsp::Compressor it comes in float and double. The double version
+ keeps the envelopes and gains in double and takes std::log2 and std::exp2
+ for the gain computer, since FastMath's approximations are float only.
+ */
+enum class FastCompressorDetectorMode
+{
+    Unlinked,
+    LinkedMax,
+    LinkedMean,
+    MidSide,
+    LinkedGroups
+};
+
+template<typename SampleType>
+struct FastCompressor
+{
+    using DetectorMode = FastCompressorDetectorMode;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    
+    void setThreshold(float newThresholdDb);
+    void setRatio    (float newRatio);
+    void setAttack   (float newAttackMs);
+    void setRelease  (float newReleaseMs);
+    void setKnee     (float newKneeDb);
+    
+    void setDetectorMode(DetectorMode newMode);
+    
+    /*
+     The layout LinkedGroups reads the channel positions from. prepare() starts
+     from the canonical layout for its channel count.
+     */
+    void setChannelLayout(const juce::AudioChannelSet& newLayout);
+    
+    // levels of the last block that was processed
+    const LevelAccumulator& getLevels() const { return levels; }
+    
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept
+    {
+        process(context, context.getInputBlock());
+    }
+    
+    // the envelope follows detectorBlock, the gain is applied to the context
+    template<typename ProcessContext>
+    void process(const ProcessContext& context, const juce::dsp::AudioBlock<const SampleType>& detectorBlock) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock =      context.getOutputBlock();
+        
+        auto numChannels = outputBlock.getNumChannels();
+        auto numSamples =  outputBlock.getNumSamples();
+        
+        jassert(inputBlock.getNumChannels() == numChannels);
+        jassert(inputBlock.getNumSamples()  == numSamples);
+        jassert(detectorBlock.getNumChannels() >= numChannels);
+        jassert(detectorBlock.getNumSamples()  >= numSamples);
+        jassert(numChannels <= channelGroups.size());
+        
+        levels.clear();
+        
+        if( context.isBypassed )
+        {
+            if( context.usesSeparateInputAndOutputBlocks() )
+                outputBlock.copyFrom(inputBlock);
+            
+            return;
+        }
+        
+        for( size_t ch = 0; ch < numChannels; ++ch )
+        {
+            detectorChannels[ch] = detectorBlock.getChannelPointer(ch);
+            inputChannels[ch] =    inputBlock.getChannelPointer(ch);
+            outputChannels[ch] =   outputBlock.getChannelPointer(ch);
+        }
+        
+        processChannels(numChannels, numSamples);
+    }
+private:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    
+    static constexpr size_t chunkSize = 64;
+    
+    std::vector<const SampleType*> detectorChannels, inputChannels;
+    std::vector<SampleType*> outputChannels;
+    
+    /*
+     Group g is lane g % Register::size() of register g / Register::size().
+     The envelope lanes hold a chunk of every register, register by register.
+     */
+    std::vector<Register> envelopeState, envelopeLanes;
+    
+    // per chunk scratch, sized so nothing is allocated while processing; the
+    // groups' levels, and then their gains, are packed one group after the other
+    std::vector<SampleType> gains, knee;
+    std::array<SampleType, chunkSize> scratch, mid, side;
+    
+    DetectorMode detectorMode { DetectorMode::Unlinked };
+    
+    // position of every channel of the layout, see setChannelLayout()
+    std::vector<int> channelPositions;
+    
+    // the groups of the current mode, built for numMappedChannels channels
+    std::vector<size_t> channelGroups, groupSizes;
+    std::vector<bool> firstInGroup;
+    size_t numGroups { 0 };
+    size_t numMappedChannels { 0 };
+    
+    LevelAccumulator levels;
+    
+    double sampleRate { 44100.0 };
+    
+    float thresholdDb { 0.f }, ratio { 1.f }, attackMs { 1.f }, releaseMs { 100.f }, kneeDb { 0.f };
+    
+    SampleType attackCoefficient { 0 }, releaseCoefficient { 0 };
+    SampleType slope { 0 }, halfKnee { 0 }, kneeScale { 0 };
+    
+    void update();
+    
+    // never allocates, so processChannels() can rebuild the groups for a block
+    // with fewer channels than were prepared
+    void updateGroups(size_t numChannels) noexcept;
+    
+    void processChannels(size_t numChannels, size_t numSamples) noexcept;
+    
+    void gatherGroups  (size_t numChannels, size_t start, size_t numSamples) noexcept;
+    void gatherMidSide (size_t start, size_t numSamples) noexcept;
+    void applyGroups   (size_t numChannels, size_t start, size_t numSamples) noexcept;
+    void applyMidSide  (size_t start, size_t numSamples) noexcept;
+    
+    void followEnvelopes(size_t groups, size_t numSamples) noexcept;
+    
+    void computeGains(SampleType* levels, size_t numSamples) noexcept;
+    
+    static SampleType* getLanes(std::vector<Register>& registers)
+    {
+        return reinterpret_cast<SampleType*>(registers.data());
+    }
+};
@@ -14,7 +14,7 @@
 #include <array>
 
 //==============================================================================
-template<typename T>
+template<typename T, int Capacity = 30>
 struct Fifo
 {
     void prepare(int numChannels, int numSamples)
@@ -72,7 +72,6 @@ struct Fifo
         return fifo.getNumReady();
     }
 private:
-    static constexpr int Capacity = 30;
     std::array<T, Capacity> buffers;
     juce::AbstractFifo fifo {Capacity};
 };
@@ -0,0 +1,143 @@
+/*
+ ==============================================================================
+ 
+ LevelMeter.h
+ Created: 6 Oct 2026 2:09:37pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+//==============================================================================
+// what one band's meters show for one block
+struct MeterReading
+{
+    float inputRmsDb      { -100.f };
+    float outputRmsDb     { -100.f };
+    float inputPeakDb     { -100.f };
+    float outputPeakDb    { -100.f };
+    float gainReductionDb { 0.f };    // the most the band was turned down, <= 0
+};
+
+//==============================================================================
+/*
+ Collects the sum of squares and the peak of a block's input and output.
+ 
+ The compressor feeds it one chunk at a time right next to the gain stage,
+ while the samples are still in cache, so metering doesn't take passes of its
+ own over the band. The RMS is taken over the samples of all channels.
+ 
+ When the gains that were applied are known, the gain reduction is the lowest
+ of them. Otherwise it falls back to the output RMS relative to the input RMS.
+ 
+ Samples can be float or double; the sums are kept in the samples' own type
+ per call and only the totals are stored as floats.
+ */
+struct LevelAccumulator
+{
+    void clear() noexcept
+    {
+        input =  {};
+        output = {};
+        minimumGain = 1.f;
+        hasGains = false;
+    }
+    
+    template<typename SampleType>
+    void addInput (const SampleType* samples, size_t numSamples) noexcept { accumulate(samples, numSamples, input); }
+    
+    template<typename SampleType>
+    void addOutput(const SampleType* samples, size_t numSamples) noexcept { accumulate(samples, numSamples, output); }
+    
+    // for a block that went through untouched
+    void copyInputToOutput() noexcept { output = input; }
+    
+    void add(const LevelAccumulator& other) noexcept
+    {
+        input.add (other.input);
+        output.add(other.output);
+        minimumGain = juce::jmin(minimumGain, other.minimumGain);
+        hasGains = hasGains || other.hasGains;
+    }
+    
+    template<typename SampleType>
+    void addGains(const SampleType* gains, size_t numSamples) noexcept
+    {
+        auto lowest = juce::FloatVectorOperations::findMinimum(gains, static_cast<int>(numSamples));
+        minimumGain = juce::jmin(minimumGain, static_cast<float>(lowest));
+        hasGains = true;
+    }
+    
+    MeterReading getReading() const noexcept
+    {
+        MeterReading reading;
+        reading.inputRmsDb =   juce::Decibels::gainToDecibels(input.getRMS());
+        reading.outputRmsDb =  juce::Decibels::gainToDecibels(output.getRMS());
+        reading.inputPeakDb =  juce::Decibels::gainToDecibels(input.peak);
+        reading.outputPeakDb = juce::Decibels::gainToDecibels(output.peak);
+        
+        reading.gainReductionDb = hasGains ? juce::Decibels::gainToDecibels(minimumGain)
+                                           : juce::jmin(0.f, reading.outputRmsDb - reading.inputRmsDb);
+        return reading;
+    }
+private:
+    struct Levels
+    {
+        float sumOfSquares { 0.f };
+        float peak { 0.f };
+        size_t numSamples { 0 };
+        
+        float getRMS() const noexcept
+        {
+            return numSamples > 0 ? std::sqrt(sumOfSquares / static_cast<float>(numSamples)) : 0.f;
+        }
+        
+        void add(const Levels& other) noexcept
+        {
+            sumOfSquares += other.sumOfSquares;
+            peak = juce::jmax(peak, other.peak);
+            numSamples += other.numSamples;
+        }
+    };
+    
+    Levels input, output;
+    float minimumGain { 1.f };
+    bool hasGains { false };
+    
+    template<typename SampleType>
+    static void accumulate(const SampleType* samples, size_t numSamples, Levels& levels) noexcept
+    {
+        // separate partial sums keep the adds independent of each other, so the
+        // loop vectorises without the compiler having to reassociate them
+        constexpr size_t numSums = 8;
+        SampleType sums[numSums] {};
+        
+        size_t i = 0;
+        for( ; i + numSums <= numSamples; i += numSums )
+        {
+            for( size_t j = 0; j < numSums; ++j )
+            {
+                sums[j] += samples[i + j] * samples[i + j];
+            }
+        }
+        
+        for( ; i < numSamples; ++i )
+        {
+            sums[0] += samples[i] * samples[i];
+        }
+        
+        for( auto sum : sums )
+        {
+            levels.sumOfSquares += static_cast<float>(sum);
+        }
+        
+        auto range = juce::FloatVectorOperations::findMinAndMax(samples, static_cast<int>(numSamples));
+        levels.peak = juce::jmax(levels.peak, static_cast<float>(-range.getStart()), static_cast<float>(range.getEnd()));
+        levels.numSamples += numSamples;
+    }
+};
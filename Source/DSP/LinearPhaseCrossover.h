@@ -0,0 +1,372 @@
+/*
+ ==============================================================================
+ 
+ LinearPhaseCrossover.h
+ Created: 3 Oct 2026 6:40:12pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <vector>
+
+//==============================================================================
+/*
+ Phase coherent alternative to LinkwitzRileyCrossover.
+ 
+ Every band is a linear phase FIR whose magnitude is the matching Linkwitz-Riley
+ band response. LR4 lowpass and highpass magnitudes add up to exactly 1, so the
+ band kernels add up to a pure delay of half the kernel length and the bands
+ sum back to the (delayed) input.
+ 
+ The kernels run through juce::dsp::Convolution, which does uniformly
+ partitioned FFT convolution. A fixed partition size keeps the cost of long
+ kernels independent of the host block size, at the price of partitionSize
+ samples of extra latency. Kernels are designed on a background thread whenever
+ a crossover frequency changes, and Convolution crossfades to the new ones.
+ While the crossover is disabled the thread leaves the kernels alone, and
+ catches up with all the changes it missed in one design once it's enabled.
+ 
+ Every band has its own convolution, so a band nobody listens to can be left
+ out without touching the others. Its history is cleared before it runs again,
+ which makes it start like a signal coming in from silence: its output is
+ truncated until getFillSamples() of input have gone through it.
+ 
+ juce::dsp::Convolution only handles mono and stereo, so each band has one
+ convolution per pair of channels, and a surround bus is split into pairs
+ on the way through. They share the band's kernel.
+ 
+ juce::dsp::Convolution only runs on floats. Double blocks are converted into
+ preallocated float buffers on the way in and back on the way out; next to
+ the FFTs that is a small cost, and the kernels are only float accurate
+ anyway.
+ */
+template<size_t NumBands>
+struct LinearPhaseCrossover : private juce::Thread
+{
+    static_assert(NumBands >= 2, "a crossover needs at least two bands");
+    
+    static constexpr size_t numBands =      NumBands;
+    static constexpr size_t numCrossovers = numBands - 1;
+    
+    using BandBlocks =       std::array<juce::dsp::AudioBlock<float>,  numBands>;
+    using DoubleBandBlocks = std::array<juce::dsp::AudioBlock<double>, numBands>;
+    using BandMask =         std::bitset<numBands>;
+    
+    LinearPhaseCrossover() : juce::Thread("Linear phase crossover")
+    {
+        for( size_t i = 0; i < numCrossovers; ++i )
+        {
+            targetFrequencies[i].store(designedFrequencies[i]);
+        }
+    }
+    
+    ~LinearPhaseCrossover() override
+    {
+        stopThread(1000);
+    }
+    
+    /*
+     Must be called off the audio thread. The first set of kernels is designed
+     here synchronously so the crossover is usable straight away.
+     */
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        stopThread(1000);
+        
+        sampleRate = spec.sampleRate;
+        
+        // ~170 ms of kernel, which is enough resolution for a 20 Hz split
+        kernelSize = juce::nextPowerOfTwo(juce::roundToInt(sampleRate / 6.0));
+        
+        for( size_t i = 0; i < numCrossovers; ++i )
+        {
+            designedFrequencies[i] = targetFrequencies[i].load();
+        }
+        
+        auto numPairs = (spec.numChannels + 1) / 2;
+        
+        for( auto& band : convolutions )
+        {
+            band.resize(numPairs);
+            
+            for( auto& convolution : band )
+            {
+                if( convolution == nullptr )
+                    convolution = std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::Latency { partitionSize },
+                                                                           messageQueue);
+            }
+        }
+        
+        designKernels();
+        
+        for( auto& band : convolutions )
+        {
+            for( juce::uint32 pair = 0; pair < numPairs; ++pair )
+            {
+                auto pairSpec = spec;
+                pairSpec.numChannels = juce::jmin(2u, spec.numChannels - pair * 2);
+                band[pair]->prepare(pairSpec);
+            }
+        }
+        
+        auto numChannels = static_cast<int>(spec.numChannels);
+        auto maximumBlockSize = static_cast<int>(spec.maximumBlockSize);
+        inputScratch.setSize(numChannels, maximumBlockSize);
+        bandScratch.setSize (numChannels * static_cast<int>(numBands), maximumBlockSize);
+        
+        convolutionLatency = convolutions.front().front()->getLatency();
+        latency = kernelSize / 2 + convolutionLatency;
+        
+        startThread();
+    }
+    
+    void reset()
+    {
+        for( auto& band : convolutions )
+        {
+            for( auto& convolution : band )
+                convolution->reset();
+        }
+        
+        skippedBands.reset();
+    }
+    
+    int getLatencyInSamples() const { return latency; }
+    
+    // how long a band runs after a reset before its FIR has a full history again
+    int getFillSamples() const { return kernelSize + convolutionLatency; }
+    
+    // safe to call from the audio thread, the kernels are rebuilt in the background
+    void setCrossoverFrequency(size_t index, float frequency)
+    {
+        jassert(index < numCrossovers);
+        targetFrequencies[index].store(frequency);
+    }
+    
+    // whether anything listens to the crossover, safe to call from the audio thread
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled); }
+    
+    void process(const juce::dsp::AudioBlock<const float>& input, BandBlocks& bands)
+    {
+        process(input, bands, BandMask().set());
+    }
+    
+    // bands that aren't in activeBands are left untouched
+    void process(const juce::dsp::AudioBlock<const float>& input, BandBlocks& bands, const BandMask& activeBands)
+    {
+        auto numChannels = input.getNumChannels();
+        auto numSamples =  input.getNumSamples();
+        jassert((numChannels + 1) / 2 <= convolutions.front().size());
+        
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            if( ! activeBands[band] )
+            {
+                skippedBands.set(band);
+                continue;
+            }
+            
+            if( skippedBands[band] )
+            {
+                for( auto& convolution : convolutions[band] )
+                    convolution->reset();
+                
+                skippedBands.reset(band);
+            }
+            
+            auto output = bands[band].getSubBlock(0, numSamples);
+            
+            for( size_t first = 0; first < numChannels; first += 2 )
+            {
+                auto num = juce::jmin(numChannels - first, static_cast<size_t>(2));
+                auto pairOutput = output.getSubsetChannelBlock(first, num);
+                auto context = juce::dsp::ProcessContextNonReplacing<float>(input.getSubsetChannelBlock(first, num), pairOutput);
+                convolutions[band][first / 2]->process(context);
+            }
+        }
+    }
+    
+    // the same, for double blocks of up to the prepared size
+    void process(const juce::dsp::AudioBlock<const double>& input, DoubleBandBlocks& bands, const BandMask& activeBands)
+    {
+        auto numChannels = input.getNumChannels();
+        auto numSamples =  input.getNumSamples();
+        jassert(numChannels <= static_cast<size_t>(inputScratch.getNumChannels()));
+        jassert(numSamples  <= static_cast<size_t>(inputScratch.getNumSamples()));
+        
+        auto floatInput = juce::dsp::AudioBlock<float>(inputScratch)
+                            .getSubsetChannelBlock(0, numChannels)
+                            .getSubBlock(0, numSamples);
+        convert(input, floatInput);
+        
+        auto scratch = juce::dsp::AudioBlock<float>(bandScratch);
+        BandBlocks floatBands;
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            floatBands[band] = scratch.getSubsetChannelBlock(band * numChannels, numChannels)
+                                      .getSubBlock(0, numSamples);
+        }
+        
+        process(juce::dsp::AudioBlock<const float>(floatInput), floatBands, activeBands);
+        
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            if( activeBands[band] )
+                convert(juce::dsp::AudioBlock<const float>(floatBands[band]), bands[band]);
+        }
+    }
+private:
+    juce::dsp::ConvolutionMessageQueue messageQueue;
+    std::array<std::vector<std::unique_ptr<juce::dsp::Convolution>>, numBands> convolutions;   // per channel pair
+    BandMask skippedBands;
+    
+    std::array<std::atomic<float>, numCrossovers> targetFrequencies;
+    std::array<float, numCrossovers> designedFrequencies { initialFrequencies() };
+    std::atomic<bool> enabled { true };
+    
+    static constexpr int partitionSize = 512;
+    
+    double sampleRate { 44100.0 };
+    int kernelSize { 8192 };
+    int convolutionLatency { 0 };
+    int latency { 0 };
+    
+    juce::AudioBuffer<float> inputScratch, bandScratch;
+    
+    template<typename Source, typename Destination>
+    static void convert(const juce::dsp::AudioBlock<const Source>& source, const juce::dsp::AudioBlock<Destination>& destination) noexcept
+    {
+        for( size_t ch = 0; ch < source.getNumChannels(); ++ch )
+        {
+            auto* in =  source.getChannelPointer(ch);
+            auto* out = destination.getChannelPointer(ch);
+            
+            for( size_t i = 0; i < source.getNumSamples(); ++i )
+                out[i] = static_cast<Destination>(in[i]);
+        }
+    }
+    
+    static std::array<float, numCrossovers> initialFrequencies()
+    {
+        std::array<float, numCrossovers> frequencies;
+        for( size_t i = 0; i < numCrossovers; ++i )
+        {
+            frequencies[i] = 1000.f;
+        }
+        
+        return frequencies;
+    }
+    
+    void run() override
+    {
+        while( ! threadShouldExit() )
+        {
+            // a crossover sweep in minimum phase mode would otherwise keep
+            // designing kernels nobody hears
+            if( ! enabled.load() )
+            {
+                wait(20);
+                continue;
+            }
+            
+            auto changed = false;
+            for( size_t i = 0; i < numCrossovers; ++i )
+            {
+                auto target = targetFrequencies[i].load();
+                if( target != designedFrequencies[i] )
+                {
+                    designedFrequencies[i] = target;
+                    changed = true;
+                }
+            }
+            
+            if( changed )
+                designKernels();
+            
+            wait(20);
+        }
+    }
+    
+    /*
+     LR4 magnitudes, |LP| = 1 / (1 + (f/fc)^4) and |HP| = (f/fc)^4 / (1 + (f/fc)^4).
+     Band b is lowpassed by split b and highpassed by every split below it.
+     */
+    float getBandMagnitude(size_t band, float frequency) const
+    {
+        auto magnitude = 1.f;
+        
+        for( size_t i = 0; i < numCrossovers; ++i )
+        {
+            auto ratio = frequency / designedFrequencies[i];
+            auto ratio4 = ratio * ratio * ratio * ratio;
+            auto lowpass = 1.f / (1.f + ratio4);
+            
+            if( i < band )
+                magnitude *= 1.f - lowpass;
+            else if( i == band )
+                magnitude *= lowpass;
+        }
+        
+        return magnitude;
+    }
+    
+    void designKernels()
+    {
+        auto order = juce::roundToInt(std::log2(kernelSize));
+        juce::dsp::FFT fft(order);
+        
+        std::vector<float> spectrum(static_cast<size_t>(kernelSize) * 2, 0.f);
+        
+        // the FFT engines differ in how they scale the inverse, so measure it
+        std::fill(spectrum.begin(), spectrum.end(), 0.f);
+        for( int bin = 0; bin <= kernelSize / 2; ++bin )
+            spectrum[static_cast<size_t>(bin) * 2] = 1.f;
+        
+        fft.performRealOnlyInverseTransform(spectrum.data());
+        auto scale = 1.f / spectrum[0];
+        
+        auto binWidth = static_cast<float>(sampleRate / kernelSize);
+        auto centre = kernelSize / 2;
+        
+        for( size_t band = 0; band < numBands; ++band )
+        {
+            std::fill(spectrum.begin(), spectrum.end(), 0.f);
+            for( int bin = 0; bin <= kernelSize / 2; ++bin )
+            {
+                spectrum[static_cast<size_t>(bin) * 2] = getBandMagnitude(band, static_cast<float>(bin) * binWidth);
+            }
+            
+            fft.performRealOnlyInverseTransform(spectrum.data());
+            
+            // zero phase -> centred linear phase, then a Blackman window that is
+            // exactly 1 at the centre so the kernels still add up to an impulse
+            juce::AudioBuffer<float> kernel(1, kernelSize);
+            auto* k = kernel.getWritePointer(0);
+            
+            for( int n = 0; n < kernelSize; ++n )
+            {
+                auto source = (n + centre) % kernelSize;
+                auto phase = juce::MathConstants<float>::twoPi * static_cast<float>(n) / static_cast<float>(kernelSize);
+                auto window = 0.42f - 0.5f * std::cos(phase) + 0.08f * std::cos(2.f * phase);
+                
+                k[n] = spectrum[static_cast<size_t>(source)] * scale * window;
+            }
+            
+            for( auto& convolution : convolutions[band] )
+            {
+                convolution->loadImpulseResponse(juce::AudioBuffer<float>(kernel),
+                                                 sampleRate,
+                                                 juce::dsp::Convolution::Stereo::no,
+                                                 juce::dsp::Convolution::Trim::no,
+                                                 juce::dsp::Convolution::Normalise::no);
+            }
+        }
+    }
+};
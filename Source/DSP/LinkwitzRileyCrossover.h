@@ -0,0 +1,417 @@
+/*
+ ==============================================================================
+ 
+ LinkwitzRileyCrossover.h
+ Created: 2 Oct 2026 9:12:40pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/*
+ Multiband Linkwitz-Riley crossover that runs every filter section of a split,
+ for every channel, side by side in the lanes of juce::dsp::SIMDRegister.
+ 
+ Split k happens at crossover frequency k, so all of its sections share one
+ cutoff and only differ in which output they return:
+    lane group 0:   lowpass  of the signal above the previous split
+    lane group 1:   highpass of the signal above the previous split
+    lane group 2+j: allpass  of band j, which was split off earlier and has to
+                    be phase aligned with the bands above it
+ 
+ For three bands that is the same topology as the old filter chain:
+    split 0:  LP1, HP1
+    split 1:  LP2, HP2, AP2
+ 
+ The band count is a template parameter, so the split tree and the allpass
+ compensation are unrolled at compile time.
+ 
+ Each lane runs the same TPT math as juce::dsp::LinkwitzRileyFilter, so the
+ bands match the scalar chain to within rounding. SampleType is float or
+ double; a double register holds half as many lanes.
+ 
+ With cutoff smoothing on, a crossover frequency change glides over
+ smoothingTimeSeconds instead of jumping at the next block. The glide is
+ evaluated every subBlockSize samples with FastMath::tan (std::tan for
+ double), and g and h are linearly interpolated in between, so a sweep never costs a tan() per sample.
+ The sub-block phase carries over from one process() call to the next, which
+ keeps the ramp independent of the host block size.
+ */
+template<size_t NumBands, typename SampleType = float>
+struct LinkwitzRileyCrossover
+{
+    static_assert(NumBands >= 2, "a crossover needs at least two bands");
+    
+    static constexpr size_t numBands =      NumBands;
+    static constexpr size_t numCrossovers = numBands - 1;
+    
+    using BandBlocks = std::array<juce::dsp::AudioBlock<SampleType>, numBands>;
+    
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate =  spec.sampleRate;
+        numChannels = static_cast<size_t>(spec.numChannels);
+        
+        inputPointers.assign(numChannels, nullptr);
+        bandPointers.assign (numBands * numChannels, nullptr);
+        
+        for( size_t k = 0; k < numCrossovers; ++k )
+        {
+            auto& split = splits[k];
+            
+            split.numLanes = getNumGroups(k) * numChannels;
+            auto numRegisters = (split.numLanes + Register::SIMDNumElements - 1) / Register::SIMDNumElements;
+            
+            for( auto* lanes : { &split.input, &split.output,
+                                 &split.s1, &split.s2, &split.s3, &split.s4,
+                                 &split.isLowpass, &split.isHighpass, &split.isAllpass } )
+            {
+                lanes->assign(numRegisters, Register::expand(SampleType(0)));
+            }
+            
+            auto* isLowpass =  getLanes(split.isLowpass);
+            auto* isHighpass = getLanes(split.isHighpass);
+            auto* isAllpass =  getLanes(split.isAllpass);
+            
+            for( size_t lane = 0; lane < split.numLanes; ++lane )
+            {
+                auto group = lane / numChannels;
+                isLowpass [lane] = group == LowpassGroup  ? SampleType(1) : SampleType(0);
+                isHighpass[lane] = group == HighpassGroup ? SampleType(1) : SampleType(0);
+                isAllpass [lane] = group >= AllpassGroup  ? SampleType(1) : SampleType(0);
+            }
+            
+            split.smoothedCutoff.reset(sampleRate, smoothingTimeSeconds);
+            split.smoothedCutoff.setCurrentAndTargetValue(split.cutoff);
+            
+            updateCoefficients(k);
+        }
+        
+        samplesUntilRamp = 0;
+    }
+    
+    void reset()
+    {
+        for( auto& split : splits )
+        {
+            for( auto* state : { &split.s1, &split.s2, &split.s3, &split.s4 } )
+            {
+                std::fill(state->begin(), state->end(), Register::expand(SampleType(0)));
+            }
+        }
+    }
+    
+    void setCrossoverFrequency(size_t index, float frequency)
+    {
+        jassert(index < numCrossovers);
+        
+        auto& split = splits[index];
+        if( split.cutoff == frequency )
+            return;
+        
+        split.cutoff = frequency;
+        
+        if( smoothingEnabled )
+        {
+            split.smoothedCutoff.setTargetValue(frequency);
+        }
+        else
+        {
+            split.smoothedCutoff.setCurrentAndTargetValue(frequency);
+            updateCoefficients(index);
+        }
+    }
+    
+    void setCutoffSmoothingEnabled(bool shouldSmooth)
+    {
+        if( smoothingEnabled == shouldSmooth )
+            return;
+        
+        smoothingEnabled = shouldSmooth;
+        
+        if( ! smoothingEnabled )
+        {
+            // jump to wherever the cutoffs were heading
+            for( size_t k = 0; k < numCrossovers; ++k )
+            {
+                splits[k].smoothedCutoff.setCurrentAndTargetValue(splits[k].cutoff);
+                updateCoefficients(k);
+            }
+        }
+    }
+    
+    void process(const juce::dsp::AudioBlock<const SampleType>& input, BandBlocks& bands)
+    {
+        auto nc = juce::jmin(static_cast<size_t>(input.getNumChannels()), numChannels);
+        auto ns = input.getNumSamples();
+        
+        for( size_t ch = 0; ch < nc; ++ch )
+        {
+            inputPointers[ch] = input.getChannelPointer(ch);
+            
+            for( size_t band = 0; band < numBands; ++band )
+            {
+                jassert(bands[band].getNumChannels() >= nc);
+                jassert(bands[band].getNumSamples() >= ns);
+                bandPointers[band * numChannels + ch] = bands[band].getChannelPointer(ch);
+            }
+        }
+        
+        if( isRamping() )
+        {
+            for( size_t i = 0; i < ns; ++i )
+            {
+                stepCoefficients();
+                processSplits(i, nc, std::make_index_sequence<numCrossovers>());
+            }
+        }
+        else
+        {
+            for( size_t i = 0; i < ns; ++i )
+            {
+                processSplits(i, nc, std::make_index_sequence<numCrossovers>());
+            }
+        }
+        
+        snapToZero();
+    }
+    
+    void snapToZero() noexcept
+    {
+        for( auto& split : splits )
+        {
+            for( auto* state : { &split.s1, &split.s2, &split.s3, &split.s4 } )
+            {
+                auto* lanes = getLanes(*state);
+                for( size_t lane = 0; lane < split.numLanes; ++lane )
+                {
+                    juce::dsp::util::snapToZero(lanes[lane]);
+                }
+            }
+        }
+    }
+private:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    
+    enum Group
+    {
+        LowpassGroup,
+        HighpassGroup,
+        AllpassGroup
+    };
+    
+    struct Split
+    {
+        float cutoff { 1000.f };
+        SampleType g { 0 }, h { 0 };
+        SampleType gStep { 0 }, hStep { 0 };
+        
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> smoothedCutoff { 1000.f };
+        
+        size_t numLanes { 0 };
+        std::vector<Register> input, output;
+        std::vector<Register> s1, s2, s3, s4;
+        std::vector<Register> isLowpass, isHighpass, isAllpass;
+    };
+    
+    std::array<Split, numCrossovers> splits;
+    
+    double sampleRate { 44100.0 };
+    size_t numChannels { 0 };
+    
+    static constexpr double smoothingTimeSeconds = 0.05;
+    static constexpr int    subBlockSize = 8;
+    
+    bool smoothingEnabled { true };
+    int  samplesUntilRamp { 0 };
+    
+    std::vector<const SampleType*> inputPointers;
+    std::vector<SampleType*>       bandPointers;
+    
+    static constexpr SampleType R2 = juce::MathConstants<SampleType>::sqrt2;
+    
+    static constexpr size_t getNumGroups(size_t split) { return split + 2; }
+    
+    static SampleType* getLanes(std::vector<Register>& registers)
+    {
+        return reinterpret_cast<SampleType*>(registers.data());
+    }
+    
+    void updateCoefficients(size_t index)
+    {
+        auto& split = splits[index];
+        
+        // same rounding as juce::dsp::LinkwitzRileyFilter::update()
+        split.g = static_cast<SampleType>(std::tan(juce::MathConstants<double>::pi * split.cutoff / sampleRate));
+        split.h = static_cast<SampleType>(1.0 / (1.0 + R2 * split.g + split.g * split.g));
+        
+        split.gStep = 0;
+        split.hStep = 0;
+    }
+    
+    bool isRamping() const noexcept
+    {
+        for( const auto& split : splits )
+        {
+            if( split.smoothedCutoff.isSmoothing() || split.gStep != 0 )
+                return true;
+        }
+        
+        return false;
+    }
+    
+    void stepCoefficients() noexcept
+    {
+        if( samplesUntilRamp == 0 )
+        {
+            startCoefficientRamps();
+            samplesUntilRamp = subBlockSize;
+        }
+        
+        --samplesUntilRamp;
+        
+        for( auto& split : splits )
+        {
+            split.g += split.gStep;
+            split.h += split.hStep;
+        }
+    }
+    
+    // aims g and h at where the smoothed cutoff will be one sub-block from now
+    void startCoefficientRamps() noexcept
+    {
+        for( size_t k = 0; k < numCrossovers; ++k )
+        {
+            auto& split = splits[k];
+            
+            if( split.smoothedCutoff.isSmoothing() )
+            {
+                auto cutoff = static_cast<SampleType>(split.smoothedCutoff.skip(subBlockSize));
+                auto g = getPrewarp(juce::MathConstants<SampleType>::pi * cutoff / static_cast<SampleType>(sampleRate));
+                auto h = SampleType(1) / (SampleType(1) + R2 * g + g * g);
+                
+                split.gStep = (g - split.g) / static_cast<SampleType>(subBlockSize);
+                split.hStep = (h - split.h) / static_cast<SampleType>(subBlockSize);
+            }
+            else if( split.gStep != 0 )
+            {
+                // the glide has arrived, land on the exact coefficients
+                updateCoefficients(k);
+            }
+        }
+    }
+    
+    static SampleType getPrewarp(SampleType x) noexcept
+    {
+        if constexpr( std::is_same_v<SampleType, float> )
+            return FastMath::tan(x);
+        else
+            return std::tan(x);
+    }
+    
+    template<size_t... Index>
+    void processSplits(size_t i, size_t nc, std::index_sequence<Index...>) noexcept
+    {
+        ( processSplit<Index>(i, nc), ... );
+    }
+    
+    template<size_t Index>
+    void processSplit(size_t i, size_t nc) noexcept
+    {
+        auto* in = getLanes(splits[Index].input);
+        
+        if constexpr( Index == 0 )
+        {
+            for( size_t ch = 0; ch < nc; ++ch )
+            {
+                auto x = inputPointers[ch][i];
+                in[LowpassGroup  * numChannels + ch] = x;
+                in[HighpassGroup * numChannels + ch] = x;
+            }
+        }
+        else
+        {
+            // the upper part of the previous split is split again, and every band
+            // below it goes through this split's allpass
+            auto* previous = getLanes(splits[Index - 1].output);
+            
+            for( size_t ch = 0; ch < nc; ++ch )
+            {
+                auto upper = previous[HighpassGroup * numChannels + ch];
+                in[LowpassGroup  * numChannels + ch] = upper;
+                in[HighpassGroup * numChannels + ch] = upper;
+                
+                for( size_t band = 0; band + 1 < Index; ++band )
+                {
+                    in[(AllpassGroup + band) * numChannels + ch] = previous[(AllpassGroup + band) * numChannels + ch];
+                }
+                
+                in[(AllpassGroup + Index - 1) * numChannels + ch] = previous[LowpassGroup * numChannels + ch];
+            }
+        }
+        
+        processLanes(splits[Index]);
+        
+        if constexpr( Index == numCrossovers - 1 )
+        {
+            auto* out = getLanes(splits[Index].output);
+            
+            for( size_t ch = 0; ch < nc; ++ch )
+            {
+                for( size_t band = 0; band < Index; ++band )
+                {
+                    bandPointers[band * numChannels + ch][i] = out[(AllpassGroup + band) * numChannels + ch];
+                }
+                
+                bandPointers[Index       * numChannels + ch][i] = out[LowpassGroup  * numChannels + ch];
+                bandPointers[(Index + 1) * numChannels + ch][i] = out[HighpassGroup * numChannels + ch];
+            }
+        }
+    }
+    
+    static void processLanes(Split& split) noexcept
+    {
+        auto g =    Register::expand(split.g);
+        auto h =    Register::expand(split.h);
+        auto r2 =   Register::expand(R2);
+        auto r2g =  Register::expand(R2 + split.g);
+        
+        for( size_t r = 0; r < split.input.size(); ++r )
+        {
+            auto& s1 = split.s1[r];
+            auto& s2 = split.s2[r];
+            auto& s3 = split.s3[r];
+            auto& s4 = split.s4[r];
+            
+            auto yH = (split.input[r] - r2g * s1 - s2) * h;
+            
+            auto yB = g * yH + s1;
+            s1 = g * yH + yB;
+            
+            auto yL = g * yB + s2;
+            s2 = g * yB + yL;
+            
+            auto allpass = yL - r2 * yB + yH;
+            
+            auto yH2 = (split.isLowpass[r] * yL + split.isHighpass[r] * yH - r2g * s3 - s4) * h;
+            
+            auto yB2 = g * yH2 + s3;
+            s3 = g * yH2 + yB2;
+            
+            auto yL2 = g * yB2 + s4;
+            s4 = g * yB2 + yL2;
+            
+            split.output[r] = split.isLowpass[r] * yL2 + split.isHighpass[r] * yH2 + split.isAllpass[r] * allpass;
+        }
+    }
+};
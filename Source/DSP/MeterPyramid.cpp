@@ -0,0 +1,212 @@
+/*
+ ==============================================================================
+ 
+ MeterPyramid.cpp
+ Created: 7 Oct 2026 10:41:16am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "MeterPyramid.h"
+
+namespace
+{
+constexpr float stepsPerDb = 100.f;
+
+juce::int16 quantise(float db)
+{
+    auto steps = juce::roundToInt(db * stepsPerDb);
+    return static_cast<juce::int16>(juce::jlimit(-32768, 32767, steps));
+}
+
+float toDb(juce::int16 steps)
+{
+    return static_cast<float>(steps) / stepsPerDb;
+}
+}
+
+MeterPyramid::MeterPyramid(int nodeSize, int recentSize)
+    : framesPerNode(nodeSize),
+      recent(static_cast<size_t>(recentSize))
+{
+    jassert(nodeSize > 0 && recentSize > 0);
+}
+
+void MeterPyramid::clear()
+{
+    levels.clear();
+    numFrames = 0;
+}
+
+juce::int64 MeterPyramid::getFramesPerNode(size_t level) const
+{
+    auto frames = framesPerNode;
+    for( size_t i = 0; i < level; ++i )
+    {
+        frames *= branchFactor;
+    }
+    
+    return frames;
+}
+
+void MeterPyramid::addFrame(const MeterReading& frame)
+{
+    auto node = Node::fromFrame(frame);
+    recent[static_cast<size_t>(numFrames % static_cast<juce::int64>(recent.size()))] = node;
+    
+    if( levels.empty() )
+        levels.emplace_back();
+    
+    // the frame either starts a new node or widens the last one, on every level
+    for( size_t level = 0; level < levels.size(); ++level )
+    {
+        auto& nodes = levels[level];
+        auto index = static_cast<size_t>(numFrames / getFramesPerNode(level));
+        
+        if( index == nodes.size() )
+            nodes.push_back(node);
+        else
+            nodes.back().merge(node);
+    }
+    
+    ++numFrames;
+    
+    // once the top level has two nodes, a level above it is needed
+    while( levels.back().size() > 1 )
+    {
+        const auto& below = levels.back();
+        std::vector<Node> above;
+        above.reserve((below.size() + branchFactor - 1) / branchFactor);
+        
+        for( size_t i = 0; i < below.size(); ++i )
+        {
+            if( i % branchFactor == 0 )
+                above.push_back(below[i]);
+            else
+                above.back().merge(below[i]);
+        }
+        
+        levels.push_back(std::move(above));
+    }
+}
+
+MeterRange MeterPyramid::getRange(juce::int64 startFrame, juce::int64 endFrame) const
+{
+    MeterRange range;
+    
+    startFrame = juce::jmax(startFrame, juce::int64(0));
+    endFrame =   juce::jmin(endFrame, numFrames);
+    if( startFrame >= endFrame )
+        return range;
+    
+    auto recentSize = static_cast<juce::int64>(recent.size());
+    
+    /*
+     Walks the span from the left, each time taking the coarsest node that
+     starts right here and ends within the span. That climbs the levels from
+     the left edge and comes back down towards the right one, so it takes at
+     most a few nodes per level. The last node of a level may not be full
+     yet, and only counts up to the newest frame.
+     */
+    for( auto frame = startFrame; frame < endFrame; )
+    {
+        auto found = false;
+        
+        for( auto level = levels.size(); level-- > 0; )
+        {
+            auto nodeSize = getFramesPerNode(level);
+            if( frame % nodeSize != 0 || juce::jmin(frame + nodeSize, numFrames) > endFrame )
+                continue;
+            
+            levels[level][static_cast<size_t>(frame / nodeSize)].addTo(range);
+            frame = juce::jmin(frame + nodeSize, numFrames);
+            found = true;
+            break;
+        }
+        
+        if( found )
+            continue;
+        
+        // the edges are filled in frame by frame from the recent frames...
+        if( frame >= numFrames - recentSize )
+        {
+            recent[static_cast<size_t>(frame % recentSize)].addTo(range);
+            ++frame;
+            continue;
+        }
+        
+        // ...and before those, only whole level 0 nodes are left
+        levels[0][static_cast<size_t>(frame / framesPerNode)].addTo(range);
+        frame = (frame / framesPerNode + 1) * framesPerNode;
+    }
+    
+    return range;
+}
+
+void MeterPyramid::getRanges(juce::int64 startFrame, juce::int64 endFrame, MeterRange* ranges, int numPixels) const
+{
+    jassert(numPixels > 0);
+    auto span = endFrame - startFrame;
+    
+    for( int pixel = 0; pixel < numPixels; ++pixel )
+    {
+        auto start = startFrame + span * pixel / numPixels;
+        auto end =   startFrame + span * (pixel + 1) / numPixels;
+        
+        ranges[pixel] = getRange(start, juce::jmax(end, start + 1));
+    }
+}
+
+size_t MeterPyramid::getMemoryUsage() const
+{
+    auto numNodes = recent.size();
+    for( const auto& nodes : levels )
+    {
+        numNodes += nodes.capacity();
+    }
+    
+    return numNodes * sizeof(Node);
+}
+
+//==============================================================================
+MeterPyramid::Node MeterPyramid::Node::fromFrame(const MeterReading& frame)
+{
+    Node node;
+    node.minGainReduction = node.maxGainReduction = quantise(frame.gainReductionDb);
+    node.minInput =         node.maxInput =         quantise(frame.inputRmsDb);
+    node.minOutput =        node.maxOutput =        quantise(frame.outputRmsDb);
+    return node;
+}
+
+void MeterPyramid::Node::merge(const Node& other)
+{
+    minGainReduction = juce::jmin(minGainReduction, other.minGainReduction);
+    maxGainReduction = juce::jmax(maxGainReduction, other.maxGainReduction);
+    minInput =         juce::jmin(minInput,  other.minInput);
+    maxInput =         juce::jmax(maxInput,  other.maxInput);
+    minOutput =        juce::jmin(minOutput, other.minOutput);
+    maxOutput =        juce::jmax(maxOutput, other.maxOutput);
+}
+
+void MeterPyramid::Node::addTo(MeterRange& range) const
+{
+    if( range.isEmpty )
+    {
+        range.isEmpty = false;
+        range.minGainReductionDb = toDb(minGainReduction);
+        range.maxGainReductionDb = toDb(maxGainReduction);
+        range.minInputDb =         toDb(minInput);
+        range.maxInputDb =         toDb(maxInput);
+        range.minOutputDb =        toDb(minOutput);
+        range.maxOutputDb =        toDb(maxOutput);
+        return;
+    }
+    
+    range.minGainReductionDb = juce::jmin(range.minGainReductionDb, toDb(minGainReduction));
+    range.maxGainReductionDb = juce::jmax(range.maxGainReductionDb, toDb(maxGainReduction));
+    range.minInputDb =         juce::jmin(range.minInputDb,  toDb(minInput));
+    range.maxInputDb =         juce::jmax(range.maxInputDb,  toDb(maxInput));
+    range.minOutputDb =        juce::jmin(range.minOutputDb, toDb(minOutput));
+    range.maxOutputDb =        juce::jmax(range.maxOutputDb, toDb(maxOutput));
+}
@@ -0,0 +1,87 @@
+/*
+ ==============================================================================
+ 
+ MeterPyramid.h
+ Created: 7 Oct 2026 10:41:16am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LevelMeter.h"
+
+//==============================================================================
+// what one pixel column of a history view shows
+struct MeterRange
+{
+    bool isEmpty { true };
+    
+    float minGainReductionDb { 0.f }, maxGainReductionDb { 0.f };
+    float minInputDb  { 0.f }, maxInputDb  { 0.f };
+    float minOutputDb { 0.f }, maxOutputDb { 0.f };
+};
+
+//==============================================================================
+/*
+ Gain reduction and RMS levels of one band for a whole session, as a min/max
+ mipmap of CompressorBand's history frames.
+ 
+ Level 0 has one node per framesPerNode frames, and every level above merges
+ branchFactor nodes of the one below, so a pixel column of any width is
+ covered by at most a handful of nodes from the right level. Drawing a view
+ costs O(pixels) whether it spans seconds or hours.
+ 
+ Values are stored as int16 hundredths of a dB, 12 bytes per node. With 5 ms
+ frames and the default 32 frames per node that is about 360 KB of nodes per
+ band per hour, pyramid included. The last recentSize frames are also kept one
+ by one, for views zoomed in further than level 0.
+ 
+ Not thread safe: frames are added and queries made from the same thread,
+ the message thread in the plugin.
+ */
+struct MeterPyramid
+{
+    explicit MeterPyramid(int framesPerNode = 32, int recentSize = 4096);
+    
+    void addFrame(const MeterReading& frame);
+    void clear();
+    
+    juce::int64 getNumFrames() const { return numFrames; }
+    
+    /*
+     Everything in frames [startFrame, endFrame), or an empty range. Exact
+     as long as the partial nodes at either end are within the recent
+     frames; further back, the ends are rounded out to whole level 0 nodes.
+     */
+    MeterRange getRange(juce::int64 startFrame, juce::int64 endFrame) const;
+    
+    // splits frames [startFrame, endFrame) evenly over numPixels columns
+    void getRanges(juce::int64 startFrame, juce::int64 endFrame, MeterRange* ranges, int numPixels) const;
+    
+    size_t getMemoryUsage() const;
+private:
+    static constexpr int branchFactor = 4;
+    
+    struct Node
+    {
+        juce::int16 minGainReduction, maxGainReduction;
+        juce::int16 minInput, maxInput;
+        juce::int16 minOutput, maxOutput;
+        
+        static Node fromFrame(const MeterReading& frame);
+        void merge(const Node& other);
+        void addTo(MeterRange& range) const;
+    };
+    
+    const juce::int64 framesPerNode;
+    
+    std::vector<std::vector<Node>> levels;
+    std::vector<Node> recent;
+    juce::int64 numFrames { 0 };
+    
+    juce::int64 getFramesPerNode(size_t level) const;
+};
@@ -0,0 +1,92 @@
+/*
+ ==============================================================================
+ 
+ ParameterGroup.h
+ Created: 4 Oct 2026 10:21:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/*
+ A set of parameters that feed the same coefficient calculation.
+ 
+ Every value change bumps a generation counter, from whichever thread the host
+ calls setValue on. The audio thread calls consumeChange() once per block and
+ only recomputes when the generation moved since the last time it looked.
+ Parameter values are stored before listeners are called, so a change that
+ lands between consumeChange() and reading the values is picked up again on
+ the next block at worst.
+ */
+struct ParameterGroup : juce::AudioProcessorParameter::Listener
+{
+    ParameterGroup() = default;
+    
+    ~ParameterGroup() override
+    {
+        for( auto* param : parameters )
+        {
+            param->removeListener(this);
+        }
+    }
+    
+    void add(std::initializer_list<juce::AudioProcessorParameter*> params)
+    {
+        for( auto* param : params )
+        {
+            jassert(param != nullptr);
+            param->addListener(this);
+            parameters.push_back(param);
+        }
+    }
+    
+    // forces the next consumeChange() to report a change, e.g. after prepareToPlay
+    void markDirty() noexcept
+    {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    
+    bool consumeChange() noexcept
+    {
+        auto current = generation.load(std::memory_order_acquire);
+        if( current == consumedGeneration )
+        {
+            skippedUpdates.store(skippedUpdates.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+            return false;
+        }
+        
+        consumedGeneration = current;
+        return true;
+    }
+    
+    juce::uint64 getNumSkippedUpdates() const noexcept
+    {
+        return skippedUpdates.load(std::memory_order_relaxed);
+    }
+private:
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    
+    // starts out of step so the first block always computes coefficients
+    std::atomic<juce::uint32> generation { 1 };
+    juce::uint32 consumedGeneration { 0 };
+    
+    // only written by the audio thread, read by anyone for reporting
+    std::atomic<juce::uint64> skippedUpdates { 0 };
+    
+    void parameterValueChanged(int, float) override
+    {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    
+    void parameterGestureChanged(int, bool) override { }
+    
+    JUCE_DECLARE_NON_COPYABLE(ParameterGroup)
+};
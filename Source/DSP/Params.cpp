@@ -9,3 +9,78 @@
  */
 
 #include "Params.h"
+#include "../GUI/Utilities.h"
+
+//==============================================================================
+namespace Params
+{
+juce::String getBandName(size_t band)
+{
+    jassert(band < NumBands);
+    
+    switch( NumBands )
+    {
+        case 2:
+            return juce::StringArray { "Low", "High" }[static_cast<int>(band)];
+        case 3:
+            return juce::StringArray { "Low", "Mid", "High" }[static_cast<int>(band)];
+        case 4:
+            return juce::StringArray { "Low", "Low Mid", "High Mid", "High" }[static_cast<int>(band)];
+        case 5:
+            return juce::StringArray { "Low", "Low Mid", "Mid", "High Mid", "High" }[static_cast<int>(band)];
+        default:
+            break;
+    }
+    
+    if( band == 0 )
+        return "Low";
+    if( band == NumBands - 1 )
+        return "High";
+    
+    return "Mid " + juce::String(static_cast<int>(band));
+}
+
+juce::String getCrossoverName(size_t index)
+{
+    return getBandName(index) + "-" + getBandName(index + 1);
+}
+
+/*
+ Crossover ranges never overlap so the bands can't cross over each other.
+ The three band build keeps its original ranges, every other build splits
+ MIN_FREQUENCY...MAX_FREQUENCY into equal log-spaced regions.
+ */
+juce::NormalisableRange<float> getCrossoverRange(size_t index)
+{
+    jassert(index < NumCrossovers);
+    
+    if( NumBands == 3 )
+    {
+        return index == 0 ?
+        juce::NormalisableRange<float>(MIN_FREQUENCY, 999, 1, 1) :
+        juce::NormalisableRange<float>(1000, MAX_FREQUENCY, 1, 1);
+    }
+    
+    auto edge = [](size_t i)
+    {
+        auto proportion = static_cast<float>(i) / static_cast<float>(NumCrossovers);
+        return std::round( juce::mapToLog10(proportion, MIN_FREQUENCY, MAX_FREQUENCY) );
+    };
+    
+    auto start = edge(index);
+    auto end = (index == NumCrossovers - 1) ? MAX_FREQUENCY : edge(index + 1) - 1.f;
+    
+    return juce::NormalisableRange<float>(start, end, 1, 1);
+}
+
+float getCrossoverDefault(size_t index)
+{
+    if( NumBands == 3 )
+    {
+        return index == 0 ? 400.f : 2000.f;
+    }
+    
+    auto range = getCrossoverRange(index);
+    return std::round( std::sqrt(range.start * range.end) );
+}
+}
@@ -11,77 +11,182 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
+
+/*
+ The band count is fixed at compile time. Define SIMPLEMBCOMP_NUM_BANDS in the
+ exporter's preprocessor definitions to build the 4 or 5 band mastering versions.
+ The three band build keeps the parameter IDs of existing sessions.
+ */
+#ifndef SIMPLEMBCOMP_NUM_BANDS
+ #define SIMPLEMBCOMP_NUM_BANDS 3
+#endif
 
 //==============================================================================
 namespace Params
 {
+static constexpr size_t NumBands =      SIMPLEMBCOMP_NUM_BANDS;
+static constexpr size_t NumCrossovers = NumBands - 1;
+
+static_assert(NumBands >= 2 && NumBands <= 8, "SimpleMBComp supports 2 to 8 bands");
+
+/*
+ Per band and per crossover parameters are laid out in runs of NumBands
+ (or NumCrossovers) entries, e.g. the threshold of band i is Threshold_Band + i.
+ */
 enum Names
 {
-    Low_Mid_Crossover_Freq,
-    Mid_High_Crossover_Freq,
+    Crossover_Freq,
     
-    Threshold_Low_Band,
-    Threshold_Mid_Band,
-    Threshold_High_Band,
+    Threshold_Band =    Crossover_Freq + NumCrossovers,
+    Attack_Band =       Threshold_Band + NumBands,
+    Release_Band =      Attack_Band + NumBands,
+    Ratio_Band =        Release_Band + NumBands,
+    Bypassed_Band =     Ratio_Band + NumBands,
+    Mute_Band =         Bypassed_Band + NumBands,
+    Solo_Band =         Mute_Band + NumBands,
+    Knee_Band =         Solo_Band + NumBands,
+    Engine_Band =       Knee_Band + NumBands,
+    Lookahead_Band =    Engine_Band + NumBands,
+    Detector_Band =     Lookahead_Band + NumBands,
     
-    Attack_Low_Band,
-    Attack_Mid_Band,
-    Attack_High_Band,
+    Gain_In =           Detector_Band + NumBands,
+    Gain_Out,
     
-    Release_Low_Band,
-    Release_Mid_Band,
-    Release_High_Band,
+    Crossover_Mode,
+    Crossover_Smoothing,
     
-    Ratio_Low_Band,
-    Ratio_Mid_Band,
-    Ratio_High_Band,
+    NumNames,
     
-    Bypassed_Low_Band,
-    Bypassed_Mid_Band,
-    Bypassed_High_Band,
+    // three band names used by the editor
+    Low_Mid_Crossover_Freq =    Crossover_Freq,
+    Mid_High_Crossover_Freq =   Crossover_Freq + NumCrossovers - 1,
     
-    Mute_Low_Band,
-    Mute_Mid_Band,
-    Mute_High_Band,
+    Threshold_Low_Band =    Threshold_Band,
+    Threshold_Mid_Band =    Threshold_Band + 1,
+    Threshold_High_Band =   Threshold_Band + NumBands - 1,
     
-    Solo_Low_Band,
-    Solo_Mid_Band,
-    Solo_High_Band,
+    Attack_Low_Band =       Attack_Band,
+    Attack_Mid_Band =       Attack_Band + 1,
+    Attack_High_Band =      Attack_Band + NumBands - 1,
     
-    Gain_In,
-    Gain_Out,
+    Release_Low_Band =      Release_Band,
+    Release_Mid_Band =      Release_Band + 1,
+    Release_High_Band =     Release_Band + NumBands - 1,
+    
+    Ratio_Low_Band =        Ratio_Band,
+    Ratio_Mid_Band =        Ratio_Band + 1,
+    Ratio_High_Band =       Ratio_Band + NumBands - 1,
+    
+    Bypassed_Low_Band =     Bypassed_Band,
+    Bypassed_Mid_Band =     Bypassed_Band + 1,
+    Bypassed_High_Band =    Bypassed_Band + NumBands - 1,
+    
+    Mute_Low_Band =         Mute_Band,
+    Mute_Mid_Band =         Mute_Band + 1,
+    Mute_High_Band =        Mute_Band + NumBands - 1,
+    
+    Solo_Low_Band =         Solo_Band,
+    Solo_Mid_Band =         Solo_Band + 1,
+    Solo_High_Band =        Solo_Band + NumBands - 1,
+};
+
+inline Names forBand(Names first, size_t band)
+{
+    jassert(band < NumBands);
+    return static_cast<Names>(first + static_cast<int>(band));
+}
+
+inline Names forCrossover(size_t index)
+{
+    jassert(index < NumCrossovers);
+    return static_cast<Names>(Crossover_Freq + static_cast<int>(index));
+}
+
+juce::String getBandName(size_t band);
+juce::String getCrossoverName(size_t index);
+
+juce::NormalisableRange<float> getCrossoverRange(size_t index);
+float getCrossoverDefault(size_t index);
+
+enum class CrossoverMode
+{
+    MinimumPhase,
+    LinearPhase
+};
+
+inline juce::StringArray getCrossoverModeChoices()
+{
+    return { "Minimum Phase", "Linear Phase" };
+}
+
+enum class CompressorEngine
+{
+    Classic,    // juce::dsp::Compressor
+    Fast        // FastCompressor
 };
 
+inline juce::StringArray getCompressorEngineChoices()
+{
+    return { "Classic", "Fast" };
+}
+
+// the ratio choices as numbers, so the audio thread never has to parse a choice name
+static constexpr std::array<float, 14> RatioChoices { 1.f, 1.5f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 10.f, 15.f, 20.f, 50.f, 100.f };
+
+inline float getRatio(int choiceIndex)
+{
+    return RatioChoices[static_cast<size_t>(juce::jlimit(0, static_cast<int>(RatioChoices.size()) - 1, choiceIndex))];
+}
+
+// same order as FastCompressorDetectorMode
+inline juce::StringArray getDetectorModeChoices()
+{
+    return { "Unlinked", "Linked Max", "Linked Mean", "Mid/Side", "Linked Groups" };
+}
+
 inline const std::map<Names, juce::String>& GetParams()
 {
-    static std::map<Names, juce::String> params =
+    static std::map<Names, juce::String> params = []()
     {
-        {Low_Mid_Crossover_Freq,    "Low-Mid Crossover Freq"},
-        {Mid_High_Crossover_Freq,   "Mid-High Crossover Freq"},
-        {Threshold_Low_Band,        "Threshold Low Band"},
-        {Threshold_Mid_Band,        "Threshold Mid Band"},
-        {Threshold_High_Band,       "Threshold High Band"},
-        {Attack_Low_Band,           "Attack Low Band"},
-        {Attack_Mid_Band,           "Attack Mid Band"},
-        {Attack_High_Band,          "Attack High Band"},
-        {Release_Low_Band,          "Release Low Band"},
-        {Release_Mid_Band,          "Release Mid Band"},
-        {Release_High_Band,         "Release High Band"},
-        {Ratio_Low_Band,            "Ratio Low Band"},
-        {Ratio_Mid_Band,            "Ratio Mid Band"},
-        {Ratio_High_Band,           "Ratio High Band"},
-        {Bypassed_Low_Band,         "Bypassed Low Band"},
-        {Bypassed_Mid_Band,         "Bypassed Mid Band"},
-        {Bypassed_High_Band,        "Bypassed High Band"},
-        {Mute_Low_Band,             "Mute Low Band"},
-        {Mute_Mid_Band,             "Mute Mid Band"},
-        {Mute_High_Band,            "Mute High Band"},
-        {Solo_Low_Band,             "Solo Low Band"},
-        {Solo_Mid_Band,             "Solo Mid Band"},
-        {Solo_High_Band,            "Solo High Band"},
-        {Gain_In,                   "Gain_In"},
-        {Gain_Out,                  "Gain_Out"},
-    };
+        std::map<Names, juce::String> names;
+        
+        for( size_t i = 0; i < NumCrossovers; ++i )
+        {
+            names[forCrossover(i)] = getCrossoverName(i) + " Crossover Freq";
+        }
+        
+        const std::vector<std::pair<Names, juce::String>> bandParams
+        {
+            {Threshold_Band,    "Threshold"},
+            {Attack_Band,       "Attack"},
+            {Release_Band,      "Release"},
+            {Ratio_Band,        "Ratio"},
+            {Bypassed_Band,     "Bypassed"},
+            {Mute_Band,         "Mute"},
+            {Solo_Band,         "Solo"},
+            {Knee_Band,         "Knee"},
+            {Engine_Band,       "Engine"},
+            {Lookahead_Band,    "Lookahead"},
+            {Detector_Band,     "Detector"},
+        };
+        
+        for( const auto& [first, prefix] : bandParams )
+        {
+            for( size_t band = 0; band < NumBands; ++band )
+            {
+                names[forBand(first, band)] = prefix + " " + getBandName(band) + " Band";
+            }
+        }
+        
+        names[Gain_In] =  "Gain_In";
+        names[Gain_Out] = "Gain_Out";
+        
+        names[Crossover_Mode] =      "Crossover Mode";
+        names[Crossover_Smoothing] = "Crossover Smoothing";
+        
+        return names;
+    }();
     
     return params;
 }
@@ -0,0 +1,55 @@
+/*
+ ==============================================================================
+ 
+ RampedParameter.h
+ Created: 15 Oct 2026 9:24:37am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+ Hosts hand automation to a plugin once per block, as the value a parameter
+ has to reach by the end of that block, so a sweep on its own turns into
+ steps as long as the host's blocks.
+ 
+ A RampedParameter spreads each of those steps over the block it came with.
+ begin() picks up the new target at the start of a host block, the ramp
+ starting from wherever the previous one ended, and getValue() gives the
+ value a given proportion of the way through the block. Audio thread only.
+ */
+struct RampedParameter
+{
+    void setParameter(juce::AudioParameterFloat* parameterToUse)
+    {
+        parameter = parameterToUse;
+        snap();
+    }
+    
+    // true while the value moves during this block
+    bool begin() noexcept
+    {
+        start = target;
+        target = parameter->get();
+        return isRamping();
+    }
+    
+    // skips the ramp, e.g. after prepareToPlay
+    void snap() noexcept
+    {
+        start = target = parameter->get();
+    }
+    
+    bool isRamping() const noexcept { return start != target; }
+    
+    float getValue(float proportion) const noexcept { return start + (target - start) * proportion; }
+    float getTarget() const noexcept { return target; }
+private:
+    juce::AudioParameterFloat* parameter { nullptr };
+    float start { 0.f }, target { 0.f };
+};
@@ -0,0 +1,382 @@
+/*
+ ==============================================================================
+ 
+ RealtimeGuard.cpp
+ Created: 13 Oct 2026 9:12:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "RealtimeGuard.h"
+
+#if SIMPLEMBCOMP_RT_GUARD
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_MAC
+ #include <malloc/malloc.h>
+ #include <pthread.h>
+#elif JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace
+{
+std::array<std::atomic<juce::uint64>, RealtimeGuard::NumViolations> counts {};
+
+/*
+ The depth of open Scopes on the calling thread. Apple's thread_local can
+ allocate the first time a thread touches it, which would come straight back
+ into the malloc hook, so a pthread key stands in for it there.
+ */
+#if JUCE_MAC
+pthread_key_t depthKey = []()
+{
+    pthread_key_t key;
+    pthread_key_create(&key, nullptr);
+    return key;
+}();
+
+intptr_t getDepth() noexcept { return reinterpret_cast<intptr_t>(pthread_getspecific(depthKey)); }
+void setDepth(intptr_t depth) noexcept { pthread_setspecific(depthKey, reinterpret_cast<void*>(depth)); }
+#else
+thread_local intptr_t depth = 0;
+
+intptr_t getDepth() noexcept { return depth; }
+void setDepth(intptr_t newDepth) noexcept { depth = newDepth; }
+#endif
+
+void check(RealtimeGuard::Violation violation) noexcept
+{
+    if( RealtimeGuard::isActive() )
+        RealtimeGuard::report(violation);
+}
+}
+
+//==============================================================================
+RealtimeGuard::Scope::Scope() noexcept
+{
+    setDepth(getDepth() + 1);
+}
+
+RealtimeGuard::Scope::~Scope()
+{
+    setDepth(getDepth() - 1);
+}
+
+bool RealtimeGuard::isActive() noexcept
+{
+    return getDepth() > 0;
+}
+
+void RealtimeGuard::report(Violation violation) noexcept
+{
+    counts[static_cast<size_t>(violation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+RealtimeGuard::Counts RealtimeGuard::getCounts()
+{
+    Counts result;
+    for( size_t i = 0; i < counts.size(); ++i )
+        result.counts[i] = counts[i].load(std::memory_order_relaxed);
+    
+    return result;
+}
+
+void RealtimeGuard::resetCounts()
+{
+    for( auto& count : counts )
+        count.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+/*
+ glibc exports its allocator a second time under __libc_ names, so those hooks
+ forward without looking anything up, and operator new, which calls malloc,
+ is caught along with everything else. The aligned operator new of C++17
+ goes through aligned_alloc or posix_memalign, which end up in
+ __libc_memalign. The real pthread functions are looked up the first time
+ they're needed; dlsym only takes glibc's internal locks.
+ */
+#if JUCE_LINUX
+
+namespace
+{
+template<typename Function>
+Function getReal(std::atomic<Function>& real, const char* name) noexcept
+{
+    auto function = real.load(std::memory_order_relaxed);
+    if( function == nullptr )
+    {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        real.store(function, std::memory_order_relaxed);
+    }
+    
+    return function;
+}
+
+using MutexLock =  int (*)(pthread_mutex_t*);
+using RwLock =     int (*)(pthread_rwlock_t*);
+
+std::atomic<MutexLock> realMutexLock { nullptr }, realMutexTryLock { nullptr };
+std::atomic<RwLock>    realRdLock { nullptr }, realWrLock { nullptr }, realTryRdLock { nullptr }, realTryWrLock { nullptr };
+}
+
+extern "C"
+{
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void  __libc_free(void*);
+
+void* malloc(size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    
+    // what glibc checks before it allocates
+    if( alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0 )
+        return EINVAL;
+    
+    auto* allocated = __libc_memalign(alignment, size);
+    if( allocated == nullptr )
+        return ENOMEM;
+    
+    *ptr = allocated;
+    return 0;
+}
+
+void free(void* ptr) noexcept
+{
+    if( ptr != nullptr )
+        check(RealtimeGuard::Deallocation);
+    
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realMutexTryLock, "pthread_mutex_trylock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realRdLock, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realWrLock, "pthread_rwlock_wrlock")(lock);
+}
+
+int pthread_rwlock_tryrdlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realTryRdLock, "pthread_rwlock_tryrdlock")(lock);
+}
+
+int pthread_rwlock_trywrlock(pthread_rwlock_t* lock) noexcept
+{
+    check(RealtimeGuard::Lock);
+    return getReal(realTryWrLock, "pthread_rwlock_trywrlock")(lock);
+}
+}
+
+//==============================================================================
+/*
+ dyld swaps these in for every image loaded with the executable, including
+ the system libraries; calls from this file still reach the originals.
+ */
+#elif JUCE_MAC
+
+namespace
+{
+void* guardedMalloc(size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    return malloc(size);
+}
+
+void* guardedCalloc(size_t num, size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    return calloc(num, size);
+}
+
+void* guardedRealloc(void* ptr, size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    return realloc(ptr, size);
+}
+
+void guardedFree(void* ptr)
+{
+    if( ptr != nullptr )
+        check(RealtimeGuard::Deallocation);
+    
+    free(ptr);
+}
+
+void* guardedAlignedAlloc(size_t alignment, size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    return aligned_alloc(alignment, size);
+}
+
+int guardedPosixMemalign(void** ptr, size_t alignment, size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    return posix_memalign(ptr, alignment, size);
+}
+
+int guardedMutexLock(pthread_mutex_t* mutex)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_mutex_lock(mutex);
+}
+
+int guardedMutexTryLock(pthread_mutex_t* mutex)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_mutex_trylock(mutex);
+}
+
+int guardedRdLock(pthread_rwlock_t* lock)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_rwlock_rdlock(lock);
+}
+
+int guardedWrLock(pthread_rwlock_t* lock)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_rwlock_wrlock(lock);
+}
+
+int guardedTryRdLock(pthread_rwlock_t* lock)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_rwlock_tryrdlock(lock);
+}
+
+int guardedTryWrLock(pthread_rwlock_t* lock)
+{
+    check(RealtimeGuard::Lock);
+    return pthread_rwlock_trywrlock(lock);
+}
+
+struct Interpose
+{
+    const void* replacement;
+    const void* original;
+};
+
+__attribute__((used, section("__DATA,__interpose")))
+const Interpose interposers[]
+{
+    { reinterpret_cast<const void*>(&guardedMalloc),        reinterpret_cast<const void*>(&malloc) },
+    { reinterpret_cast<const void*>(&guardedCalloc),        reinterpret_cast<const void*>(&calloc) },
+    { reinterpret_cast<const void*>(&guardedRealloc),       reinterpret_cast<const void*>(&realloc) },
+    { reinterpret_cast<const void*>(&guardedAlignedAlloc),  reinterpret_cast<const void*>(&aligned_alloc) },
+    { reinterpret_cast<const void*>(&guardedPosixMemalign), reinterpret_cast<const void*>(&posix_memalign) },
+    { reinterpret_cast<const void*>(&guardedFree),          reinterpret_cast<const void*>(&free) },
+    { reinterpret_cast<const void*>(&guardedMutexLock),     reinterpret_cast<const void*>(&pthread_mutex_lock) },
+    { reinterpret_cast<const void*>(&guardedMutexTryLock),  reinterpret_cast<const void*>(&pthread_mutex_trylock) },
+    { reinterpret_cast<const void*>(&guardedRdLock),        reinterpret_cast<const void*>(&pthread_rwlock_rdlock) },
+    { reinterpret_cast<const void*>(&guardedWrLock),        reinterpret_cast<const void*>(&pthread_rwlock_wrlock) },
+    { reinterpret_cast<const void*>(&guardedTryRdLock),     reinterpret_cast<const void*>(&pthread_rwlock_tryrdlock) },
+    { reinterpret_cast<const void*>(&guardedTryWrLock),     reinterpret_cast<const void*>(&pthread_rwlock_trywrlock) },
+};
+}
+
+//==============================================================================
+/*
+ The CRT's malloc can't be swapped out, so on Windows only C++ allocations
+ are caught, and critical sections aren't.
+ */
+#else
+
+void* operator new(size_t size)
+{
+    check(RealtimeGuard::Allocation);
+    
+    if( auto* ptr = std::malloc(size == 0 ? 1 : size) )
+        return ptr;
+    
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    check(RealtimeGuard::Allocation);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if( ptr != nullptr )
+        check(RealtimeGuard::Deallocation);
+    
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept              { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept        { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept      { operator delete(ptr); }
+
+#endif
+
+#endif
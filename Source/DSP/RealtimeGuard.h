@@ -0,0 +1,106 @@
+/*
+ ==============================================================================
+ 
+ RealtimeGuard.h
+ Created: 13 Oct 2026 9:12:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+/*
+ Only an executable can hook malloc, free and the mutexes for everything it
+ runs, so the guard is built into the benchmark tool's Debug configuration,
+ which defines SIMPLEMBCOMP_RT_GUARD. Everywhere else a Scope is empty.
+ */
+#ifndef SIMPLEMBCOMP_RT_GUARD
+#define SIMPLEMBCOMP_RT_GUARD 0
+#endif
+
+//==============================================================================
+/*
+ Catches the audio thread doing what it mustn't: allocating, freeing, or
+ taking a mutex, any of which can block on another thread.
+ 
+ processBlock runs inside a Scope. While one is open on a thread, the hooks
+ in RealtimeGuard.cpp count every call of operator new and delete, malloc,
+ calloc, realloc, the aligned allocators and free, and of the pthread mutex
+ and rwlock lock and trylock functions from that thread. The
+ counts are process wide, and say nothing about where the call came from;
+ run the check under a debugger with a breakpoint in report() for that.
+ */
+struct RealtimeGuard
+{
+    enum Violation
+    {
+        Allocation,
+        Deallocation,
+        Lock,
+        NumViolations
+    };
+    
+    static const char* getName(int violation)
+    {
+        switch( violation )
+        {
+            case Allocation:    return "allocation";
+            case Deallocation:  return "deallocation";
+            case Lock:          return "lock";
+            default:            break;
+        }
+        
+        return "";
+    }
+    
+    struct Counts
+    {
+        std::array<juce::uint64, NumViolations> counts {};
+        
+        juce::uint64 getTotal() const
+        {
+            juce::uint64 total = 0;
+            for( auto count : counts )
+                total += count;
+            
+            return total;
+        }
+    };
+    
+#if SIMPLEMBCOMP_RT_GUARD
+    struct Scope
+    {
+        Scope() noexcept;
+        ~Scope();
+        
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+    
+    static constexpr bool isAvailable() { return true; }
+    
+    // whether the calling thread is inside a Scope, safe to call from the hooks
+    static bool isActive() noexcept;
+    
+    // the hooks' way in; never allocates or locks
+    static void report(Violation violation) noexcept;
+    
+    static Counts getCounts();
+    static void resetCounts();
+#else
+    struct Scope
+    {
+        Scope() noexcept { }
+    };
+    
+    static constexpr bool isAvailable() { return false; }
+    static bool isActive() noexcept { return false; }
+    static void report(Violation) noexcept { }
+    static Counts getCounts() { return {}; }
+    static void resetCounts() { }
+#endif
+};
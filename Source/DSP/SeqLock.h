@@ -0,0 +1,90 @@
+/*
+ ==============================================================================
+ 
+ SeqLock.h
+ Created: 6 Oct 2026 2:14:52pm
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+//==============================================================================
+/*
+ Publishes a small value from one writer thread to any number of readers
+ without a lock.
+ 
+ The writer bumps the sequence to an odd number, copies the value in and bumps
+ it to even again, so it never waits on anyone. A reader that sees the sequence
+ odd, or changed while it was copying, raced with a write and copies again.
+ The value is kept in atomic words so the racing copy isn't a data race.
+ */
+template<typename T>
+struct SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "the value is copied as raw words");
+    static_assert(sizeof(T) % sizeof(juce::uint32) == 0, "the value is copied as raw words");
+    
+    explicit SeqLock(const T& initialValue = T {})
+    {
+        store(initialValue);
+    }
+    
+    // only ever call this from one thread at a time
+    void store(const T& value) noexcept
+    {
+        Words words;
+        std::memcpy(words.data(), &value, sizeof(T));
+        
+        auto sequence = counter.load(std::memory_order_relaxed);
+        counter.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        for( size_t i = 0; i < numWords; ++i )
+        {
+            storage[i].store(words[i], std::memory_order_relaxed);
+        }
+        
+        counter.store(sequence + 2, std::memory_order_release);
+    }
+    
+    T load() const noexcept
+    {
+        Words words;
+        
+        for( ;; )
+        {
+            auto before = counter.load(std::memory_order_acquire);
+            if( (before & 1) != 0 )
+                continue;
+            
+            for( size_t i = 0; i < numWords; ++i )
+            {
+                words[i] = storage[i].load(std::memory_order_relaxed);
+            }
+            
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if( counter.load(std::memory_order_relaxed) == before )
+                break;
+        }
+        
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+private:
+    static constexpr size_t numWords = sizeof(T) / sizeof(juce::uint32);
+    using Words = std::array<juce::uint32, numWords>;
+    
+    std::atomic<juce::uint32> counter { 0 };
+    std::array<std::atomic<juce::uint32>, numWords> storage {};
+    
+    JUCE_DECLARE_NON_COPYABLE(SeqLock)
+};
@@ -29,7 +29,9 @@ struct SingleChannelSampleFifo
         prepared.set(false);
     }
     
-    void update(const BlockType& buffer)
+    // the analyzer runs on floats, a double precision buffer is converted sample by sample
+    template<typename BufferType>
+    void update(const BufferType& buffer)
     {
         jassert(prepared.get());
         jassert(buffer.getNumChannels() > channelToUse );
@@ -37,7 +39,7 @@ struct SingleChannelSampleFifo
         
         for( int i = 0; i < buffer.getNumSamples(); ++i )
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            pushNextSampleIntoFifo(static_cast<float>(channelPtr[i]));
         }
     }
     
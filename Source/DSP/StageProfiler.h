@@ -0,0 +1,156 @@
+/*
+ ==============================================================================
+ 
+ StageProfiler.h
+ Created: 8 Oct 2026 9:26:44am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "Fifo.h"
+#include "Params.h"
+
+//==============================================================================
+/*
+ One span of work on a timeline, see StageTrace. id is a StageProfiler::Stage,
+ StageProfiler::NumStages for a whole processBlock call, or one of the ids
+ StageTrace adds for the message thread.
+ */
+struct TraceEvent
+{
+    int id { 0 };
+    int numSamples { 0 };   // whole blocks only
+    juce::int64 startTicks { 0 }, endTicks { 0 };
+};
+
+using TraceFifo = Fifo<TraceEvent, 8192>;
+
+//==============================================================================
+/*
+ Adds up how long each stage of processBlock takes.
+ 
+ processBlock marks the end of every stage with a Laps object, which reads the
+ high resolution clock once per stage, and nothing at all when no profiler is
+ attached. A profiler belongs to one processor and is only touched from the
+ thread that calls processBlock, so there is nothing to synchronise.
+ */
+struct StageProfiler
+{
+    // every band's compressor is a stage of its own
+    enum Stage
+    {
+        Parameters,
+        Input,
+        Split,
+        FirstCompress,
+        Sum = FirstCompress + static_cast<int>(Params::NumBands),
+        Output,
+        NumStages
+    };
+    
+    static Stage getCompressStage(size_t band)
+    {
+        jassert(band < Params::NumBands);
+        return static_cast<Stage>(FirstCompress + static_cast<int>(band));
+    }
+    
+    static juce::String getStageName(int stage)
+    {
+        jassert(stage >= 0 && stage < NumStages);
+        
+        if( stage >= FirstCompress && stage < Sum )
+            return "band " + juce::String(stage - FirstCompress + 1);
+        
+        switch( stage )
+        {
+            case Parameters:    return "parameters";
+            case Input:         return "input";
+            case Split:         return "split";
+            case Sum:           return "sum";
+            case Output:        return "output";
+            default:            break;
+        }
+        
+        return {};
+    }
+    
+    /*
+     Every lap can also go into a trace, as its own event, followed by one for
+     the whole block once the Laps object goes out of scope. Events that don't
+     fit in the trace are dropped.
+     */
+    struct Laps
+    {
+        explicit Laps(StageProfiler* profilerToUse, TraceFifo* traceToUse = nullptr, int numSamplesInBlock = 0) noexcept
+            : profiler(profilerToUse),
+              trace(traceToUse),
+              numSamples(numSamplesInBlock),
+              firstTicks(isTiming() ? juce::Time::getHighResolutionTicks() : 0),
+              lastTicks(firstTicks)
+        {
+        }
+        
+        ~Laps()
+        {
+            if( trace != nullptr )
+                trace->push({ NumStages, numSamples, firstTicks, lastTicks });
+        }
+        
+        // everything since the previous mark counts towards stage
+        void end(Stage stage) noexcept
+        {
+            if( ! isTiming() )
+                return;
+            
+            auto now = juce::Time::getHighResolutionTicks();
+            
+            if( profiler != nullptr )
+                profiler->ticks[stage] += now - lastTicks;
+            
+            if( trace != nullptr )
+                trace->push({ stage, 0, lastTicks, now });
+            
+            lastTicks = now;
+        }
+    private:
+        StageProfiler* profiler;
+        TraceFifo* trace;
+        int numSamples;
+        juce::int64 firstTicks, lastTicks;
+        
+        bool isTiming() const noexcept { return profiler != nullptr || trace != nullptr; }
+    };
+    
+    void reset() { ticks.fill(0); }
+    
+    void add(const StageProfiler& other)
+    {
+        for( size_t i = 0; i < ticks.size(); ++i )
+        {
+            ticks[i] += other.ticks[i];
+        }
+    }
+    
+    double getSeconds(int stage) const
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks[static_cast<size_t>(stage)]);
+    }
+    
+    double getTotalSeconds() const
+    {
+        auto total = 0.0;
+        for( int stage = 0; stage < NumStages; ++stage )
+        {
+            total += getSeconds(stage);
+        }
+        
+        return total;
+    }
+private:
+    std::array<juce::int64, NumStages> ticks {};
+};
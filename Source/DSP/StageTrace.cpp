@@ -0,0 +1,128 @@
+/*
+ ==============================================================================
+ 
+ StageTrace.cpp
+ Created: 11 Oct 2026 9:07:53am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "StageTrace.h"
+
+juce::String StageTrace::getName(int id)
+{
+    jassert(id >= 0 && id < NumIds);
+    
+    switch( id )
+    {
+        case ProcessBlock:          return "processBlock";
+        case PathProducerProcess:   return "PathProducer::process";
+        case SpectrumAnalyzerPaint: return "SpectrumAnalyzer::paint";
+        default:                    break;
+    }
+    
+    return StageProfiler::getStageName(id);
+}
+
+void StageTrace::add(const TraceEvent& event)
+{
+    history.push_back(event);
+}
+
+void StageTrace::update()
+{
+    TraceEvent event;
+    while( audioThreadEvents.pull(event) )
+        history.push_back(event);
+    
+    // message thread events were added as they happened, so the front isn't
+    // always the oldest, but it's close enough to keep the history bounded
+    auto oldest = juce::Time::getHighResolutionTicks() - juce::Time::secondsToHighResolutionTicks(historySeconds);
+    while( ! history.empty() && history.front().endTicks < oldest )
+        history.pop_front();
+}
+
+std::array<float, StageTrace::NumIds> StageTrace::getLoads(double windowSeconds) const
+{
+    std::array<juce::int64, NumIds> ticks {};
+    
+    auto windowStart = juce::Time::getHighResolutionTicks() - juce::Time::secondsToHighResolutionTicks(windowSeconds);
+    for( const auto& event : history )
+    {
+        if( event.endTicks >= windowStart )
+            ticks[static_cast<size_t>(event.id)] += event.endTicks - juce::jmax(event.startTicks, windowStart);
+    }
+    
+    std::array<float, NumIds> loads;
+    for( size_t id = 0; id < loads.size(); ++id )
+    {
+        loads[id] = static_cast<float>(juce::Time::highResolutionTicksToSeconds(ticks[id]) / windowSeconds);
+    }
+    
+    return loads;
+}
+
+juce::Result StageTrace::exportChromeTrace(const juce::File& file) const
+{
+    if( history.empty() )
+        return juce::Result::fail("nothing has been traced yet");
+    
+    juce::FileOutputStream stream(file);
+    if( ! stream.openedOk() )
+        return juce::Result::fail("can't write " + file.getFullPathName());
+    
+    stream.setPosition(0);
+    stream.truncate();
+    
+    auto firstTicks = history.front().startTicks;
+    for( const auto& event : history )
+        firstTicks = juce::jmin(firstTicks, event.startTicks);
+    
+    auto toMicroseconds = [](juce::int64 ticks)
+    {
+        return juce::String(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6, 3);
+    };
+    
+    constexpr int audioThread = 1, messageThread = 2;
+    
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << audioThread << ",\"args\":{\"name\":\"audio\"}},\n"
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << messageThread << ",\"args\":{\"name\":\"message\"}}";
+    
+    auto rate = sampleRate.load();
+    
+    for( const auto& event : history )
+    {
+        auto name = getName(event.id);
+        auto args = juce::String();
+        
+        // whole blocks carry their deadline, and the late ones say so in
+        // their name so they stand out on the timeline
+        if( event.id == ProcessBlock && event.numSamples > 0 )
+        {
+            auto deadline = event.numSamples / rate;
+            auto late = juce::Time::highResolutionTicksToSeconds(event.endTicks - event.startTicks) > deadline;
+            
+            if( late )
+                name << " (late)";
+            
+            args << ",\"args\":{\"numSamples\":" << event.numSamples
+                 << ",\"deadline_us\":" << juce::String(deadline * 1.0e6, 1)
+                 << ",\"late\":" << (late ? "true" : "false") << "}";
+        }
+        
+        stream << ",\n{\"name\":\"" << name << "\""
+               << ",\"cat\":\"" << (isOnAudioThread(event.id) ? "audio" : "gui") << "\""
+               << ",\"ph\":\"X\",\"pid\":1"
+               << ",\"tid\":" << (isOnAudioThread(event.id) ? audioThread : messageThread)
+               << ",\"ts\":" << toMicroseconds(event.startTicks - firstTicks)
+               << ",\"dur\":" << toMicroseconds(event.endTicks - event.startTicks)
+               << args << "}";
+    }
+    
+    stream << "\n]}\n";
+    stream.flush();
+    
+    return stream.getStatus();
+}
@@ -0,0 +1,87 @@
+/*
+ ==============================================================================
+ 
+ StageTrace.h
+ Created: 11 Oct 2026 9:07:53am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include "StageProfiler.h"
+
+// the Debug configurations turn this on, release builds don't carry any of it
+#ifndef SIMPLEMBCOMP_TRACE
+#define SIMPLEMBCOMP_TRACE 0
+#endif
+
+//==============================================================================
+/*
+ A timeline of what processBlock and the analyzer did over the last few
+ seconds, to find out which stage made a block miss its deadline.
+ 
+ The audio thread fills getAudioThreadEvents() through StageProfiler::Laps.
+ update() drains that ring into the history on the message thread, where the
+ analyzer's own work is added directly with ScopedEvent. Everything apart
+ from the ring is message thread only.
+ */
+struct StageTrace
+{
+    // ids that follow on from StageProfiler's stages
+    enum Id
+    {
+        ProcessBlock = StageProfiler::NumStages,
+        PathProducerProcess,
+        SpectrumAnalyzerPaint,
+        NumIds
+    };
+    
+    static juce::String getName(int id);
+    static bool isOnAudioThread(int id) { return id <= ProcessBlock; }
+    
+    struct ScopedEvent
+    {
+        ScopedEvent(StageTrace& traceToUse, Id idToUse)
+            : trace(traceToUse),
+              id(idToUse),
+              startTicks(juce::Time::getHighResolutionTicks())
+        {
+        }
+        
+        ~ScopedEvent()
+        {
+            trace.add({ id, 0, startTicks, juce::Time::getHighResolutionTicks() });
+        }
+    private:
+        StageTrace& trace;
+        Id id;
+        juce::int64 startTicks;
+        
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+    
+    TraceFifo& getAudioThreadEvents() { return audioThreadEvents; }
+    
+    void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+    
+    void add(const TraceEvent& event);
+    void update();
+    
+    // the share of real time each id took over the last windowSeconds
+    std::array<float, NumIds> getLoads(double windowSeconds) const;
+    
+    // the history as Chrome trace event JSON, which Perfetto opens too
+    juce::Result exportChromeTrace(const juce::File& file) const;
+private:
+    static constexpr double historySeconds = 10.0;
+    
+    TraceFifo audioThreadEvents;
+    std::deque<TraceEvent> history;
+    std::atomic<double> sampleRate { 44100.0 };
+};
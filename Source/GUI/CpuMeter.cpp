@@ -0,0 +1,60 @@
+/*
+ ==============================================================================
+ 
+ CpuMeter.cpp
+ Created: 12 Oct 2026 10:18:52am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "CpuMeter.h"
+#include "LookAndFeel.h"
+
+void CpuMeter::update(float peakLoad, const DeadlineStats& newStats)
+{
+    // jumps up to a new peak, then falls back slowly enough to be read
+    displayedLoad = juce::jmax(peakLoad, displayedLoad * 0.9f);
+    stats = newStats;
+    repaint();
+}
+
+void CpuMeter::paint(juce::Graphics& g)
+{
+    using namespace juce;
+    
+    auto bounds = getLocalBounds().toFloat();
+    
+    auto textArea = bounds.removeFromRight(bounds.getWidth() * 0.55f);
+    auto bar = bounds.reduced(2.f, 4.f);
+    
+    g.setColour(ColorScheme::getMeterLineColor());
+    g.drawRect(bar, 1.f);
+    
+    auto fill = bar.reduced(1.f);
+    fill.setWidth(fill.getWidth() * jlimit(0.f, 1.f, displayedLoad));
+    
+    auto colour = displayedLoad >= 1.f                         ? Colours::red
+                : displayedLoad >= DeadlineStats::nearMissLoad ? ColorScheme::getOrangeBorderColor()
+                                                               : ColorScheme::getGainReductionColor();
+    g.setColour(colour);
+    g.fillRect(fill);
+    
+    auto text = "CPU " + String(roundToInt(displayedLoad * 100.f)) + "%";
+    if( stats.numMisses > 0 || stats.numNearMisses > 0 )
+        text << "  " << String(stats.numMisses) << "/" << String(stats.numNearMisses);
+    
+    g.setColour(stats.numMisses > 0 ? Colours::red : ColorScheme::getScaleTextColor());
+    g.setFont(11.f);
+    g.drawFittedText(text, textArea.toNearestInt(), Justification::centredLeft, 1);
+}
+
+void CpuMeter::mouseDown(const juce::MouseEvent&)
+{
+    if( onReset )
+        onReset();
+    
+    displayedLoad = 0.f;
+    stats = {};
+    repaint();
+}
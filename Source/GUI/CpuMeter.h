@@ -0,0 +1,34 @@
+/*
+ ==============================================================================
+ 
+ CpuMeter.h
+ Created: 12 Oct 2026 10:18:52am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/DeadlineMonitor.h"
+
+//==============================================================================
+/*
+ How much of its real time budget processBlock used recently, and how many
+ blocks came close to, or missed, their deadline. Clicking it starts the
+ counts over.
+ */
+struct CpuMeter : juce::Component
+{
+    // peakLoad is the worst load since the last update
+    void update(float peakLoad, const DeadlineStats& stats);
+    
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& e) override;
+    
+    std::function<void()> onReset;
+private:
+    float displayedLoad { 0.f };
+    DeadlineStats stats;
+};
@@ -77,6 +77,9 @@ void SpectrumAnalyzer::drawFFTAnalysis(juce::Graphics &g, juce::Rectangle<int> b
 
 void SpectrumAnalyzer::paint (juce::Graphics& g)
 {
+#if SIMPLEMBCOMP_TRACE
+    StageTrace::ScopedEvent event(audioProcessor.getTrace(), StageTrace::SpectrumAnalyzerPaint);
+#endif
     using namespace juce;
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (Colours::black);
@@ -172,23 +175,20 @@ void SpectrumAnalyzer::drawCrossovers(juce::Graphics &g, juce::Rectangle<int> bo
                          right);
 }
 
-void SpectrumAnalyzer::update(const std::vector<float> &values)
+void SpectrumAnalyzer::update(const std::vector<float> &gainReductions)
 {
-    jassert(values.size() == 6);
+    jassert(gainReductions.size() == 3);
     
     enum
     {
-        LowBandIn,
-        LowBandOut,
-        MidBandIn,
-        MidBandOut,
-        HighBandIn,
-        HighBandOut
+        LowBand,
+        MidBand,
+        HighBand
     };
     
-    lowBandGR =  values[LowBandOut] -  values[LowBandIn];
-    midBandGR =  values[MidBandOut] -  values[MidBandIn];
-    highBandGR = values[HighBandOut] - values[HighBandIn];
+    lowBandGR =  gainReductions[LowBand];
+    midBandGR =  gainReductions[MidBand];
+    highBandGR = gainReductions[HighBand];
     
     repaint();
 }
@@ -377,8 +377,13 @@ void SpectrumAnalyzer::timerCallback()
         fftBounds.setBottom(bounds.getBottom());
         auto sampleRate = audioProcessor.getSampleRate();
         
-        leftPathProducer.process (fftBounds, sampleRate);
-        rightPathProducer.process(fftBounds, sampleRate);
+        {
+#if SIMPLEMBCOMP_TRACE
+            StageTrace::ScopedEvent event(audioProcessor.getTrace(), StageTrace::PathProducerProcess);
+#endif
+            leftPathProducer.process (fftBounds, sampleRate);
+            rightPathProducer.process(fftBounds, sampleRate);
+        }
     }
     
     if( parametersChanged.compareAndSetBool(false, true) )
@@ -35,7 +35,8 @@ juce::Timer
         shouldShowFFTAnalysis = enabled;
     }
     
-    void update(const std::vector<float>& values);
+    // one gain reduction in dB per band
+    void update(const std::vector<float>& gainReductions);
 private:
     SimpleMBCompAudioProcessor& audioProcessor;
     
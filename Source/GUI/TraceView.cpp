@@ -0,0 +1,84 @@
+/*
+ ==============================================================================
+ 
+ TraceView.cpp
+ Created: 11 Oct 2026 10:26:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "TraceView.h"
+#include "LookAndFeel.h"
+
+TraceView::TraceView(StageTrace& traceToShow) : trace(traceToShow)
+{
+}
+
+void TraceView::update()
+{
+    trace.update();
+    loads = trace.getLoads(1.0);
+    repaint();
+}
+
+int TraceView::getIdealHeight() const
+{
+    return rowHeight * StageTrace::NumIds + 4;
+}
+
+void TraceView::paint(juce::Graphics& g)
+{
+    using namespace juce;
+    
+    g.setColour(Colours::black.withAlpha(0.7f));
+    g.fillRect(getLocalBounds());
+    
+    g.setFont(static_cast<float>(rowHeight - 1));
+    
+    auto bounds = getLocalBounds().reduced(2);
+    for( int id = 0; id < StageTrace::NumIds; ++id )
+    {
+        auto row = bounds.removeFromTop(rowHeight);
+        auto load = loads[static_cast<size_t>(id)];
+        
+        auto nameArea = row.removeFromLeft(row.getWidth() / 2);
+        auto valueArea = row.removeFromRight(40);
+        
+        // a full bar is 10 % of real time, whole blocks get 100 %
+        auto fullScale = id == StageTrace::ProcessBlock ? 1.f : 0.1f;
+        auto bar = row.reduced(0, 2).toFloat();
+        bar.setWidth(bar.getWidth() * jlimit(0.f, 1.f, load / fullScale));
+        
+        g.setColour(StageTrace::isOnAudioThread(id) ? ColorScheme::getSliderFillColor()
+                                                    : ColorScheme::getThresholdColor());
+        g.fillRect(bar);
+        
+        g.setColour(ColorScheme::getScaleTextColor());
+        g.drawFittedText(StageTrace::getName(id), nameArea, Justification::centredLeft, 1);
+        g.drawFittedText(String(load * 100.f, 1) + " %", valueArea, Justification::centredRight, 1);
+    }
+}
+
+void TraceView::mouseDown(const juce::MouseEvent&)
+{
+    juce::PopupMenu menu;
+    menu.addItem("Export Chrome trace to the Desktop", [this]() { exportTrace(); });
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void TraceView::exportTrace()
+{
+    trace.update();
+    
+    auto name = "SimpleMBComp trace " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H%M%S") + ".json";
+    auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile(name);
+    
+    auto result = trace.exportChromeTrace(file);
+    
+    juce::AlertWindow::showMessageBoxAsync(result.wasOk() ? juce::MessageBoxIconType::InfoIcon
+                                                          : juce::MessageBoxIconType::WarningIcon,
+                                           "Trace export",
+                                           result.wasOk() ? "Saved " + file.getFullPathName()
+                                                          : result.getErrorMessage());
+}
@@ -0,0 +1,41 @@
+/*
+ ==============================================================================
+ 
+ TraceView.h
+ Created: 11 Oct 2026 10:26:40am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/StageTrace.h"
+
+//==============================================================================
+/*
+ Live CPU breakdown of a StageTrace: the share of real time every stage of
+ processBlock, and the analyzer's work on the message thread, took over the
+ last second. Clicking it offers to export the trace for chrome://tracing or
+ Perfetto.
+ */
+struct TraceView : juce::Component
+{
+    explicit TraceView(StageTrace& traceToShow);
+    
+    // drains the trace, call it from the editor's timer
+    void update();
+    
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& e) override;
+    
+    int getIdealHeight() const;
+private:
+    StageTrace& trace;
+    std::array<float, StageTrace::NumIds> loads {};
+    
+    static constexpr int rowHeight = 11;
+    
+    void exportTrace();
+};
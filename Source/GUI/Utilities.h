@@ -19,6 +19,8 @@
 #define MAX_DECIBELS 12.f
 
 #define MIN_THRESHOLD -60.f
+
+#define MAX_LOOKAHEAD_MS 10.f
 //==============================================================================
 enum FFTOrder
 {
@@ -0,0 +1,302 @@
+/*
+ ==============================================================================
+ 
+ ChunkedRenderer.cpp
+ Created: 9 Oct 2026 9:48:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "ChunkedRenderer.h"
+#include "WorkStealingScheduler.h"
+
+//==============================================================================
+// everything the workers share for one file
+struct ChunkedRenderer::Render
+{
+    Render(const juce::File& file, juce::int64 length, juce::int64 size, juce::int64 prerollSamples, int numWorkers)
+        : input(file),
+          numSamples(length),
+          chunkSize(size),
+          preroll(prerollSamples),
+          numChunks(static_cast<int>((length + size - 1) / size)),
+          scheduler(numChunks, numWorkers),
+          finished(static_cast<size_t>(numChunks))
+    {
+    }
+    
+    juce::int64 getChunkStart(int chunk) const { return chunkSize * chunk; }
+    juce::int64 getChunkEnd(int chunk) const { return juce::jmin(numSamples, chunkSize * (chunk + 1)); }
+    
+    void finish(int chunk, std::unique_ptr<juce::AudioBuffer<float>> buffer)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            finished[static_cast<size_t>(chunk)] = std::move(buffer);
+        }
+        
+        chunkFinished.signal();
+    }
+    
+    void fail(const juce::Result& result)
+    {
+        {
+            const juce::ScopedLock sl(lock);
+            if( error.wasOk() )
+                error = result;
+        }
+        
+        chunkFinished.signal();
+    }
+    
+    // blocks until chunk is done, or returns nullptr once a worker has failed
+    std::unique_ptr<juce::AudioBuffer<float>> waitFor(int chunk)
+    {
+        while( true )
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                if( error.failed() )
+                    return nullptr;
+                
+                auto& buffer = finished[static_cast<size_t>(chunk)];
+                if( buffer != nullptr )
+                    return std::move(buffer);
+            }
+            
+            chunkFinished.wait(100);
+        }
+    }
+    
+    juce::Result getError() const
+    {
+        const juce::ScopedLock sl(lock);
+        return error;
+    }
+    
+    const juce::File input;
+    const juce::int64 numSamples, chunkSize, preroll;
+    const int numChunks;
+    
+    WorkStealingScheduler scheduler;
+private:
+    juce::CriticalSection lock;
+    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> finished;
+    juce::Result error { juce::Result::ok() };
+    juce::WaitableEvent chunkFinished;
+};
+
+//==============================================================================
+struct ChunkedRenderer::Worker : juce::Thread
+{
+    Worker(const RenderSettings& settings, int workerIndex)
+        : juce::Thread("SimpleMBCompRender chunk worker " + juce::String(workerIndex)),
+          renderer(settings),
+          index(workerIndex)
+    {
+    }
+    
+    void start(Render& jobToJoin)
+    {
+        job = &jobToJoin;
+        stats = {};
+        gainReductions.fill(0.f);
+        startThread();
+    }
+    
+    void run() override
+    {
+        // readers aren't thread safe, so every worker opens the file itself
+        auto reader = renderer.createReaderFor(job->input);
+        if( reader == nullptr )
+        {
+            job->fail(juce::Result::fail("can't read " + job->input.getFullPathName()));
+            return;
+        }
+        
+        auto numChannels = static_cast<int>(reader->numChannels);
+        int chunk;
+        
+        while( ! threadShouldExit() && job->scheduler.getNextTask(index, chunk) )
+        {
+            auto start = job->getChunkStart(chunk);
+            auto end =   job->getChunkEnd(chunk);
+            
+            auto buffer = std::make_unique<juce::AudioBuffer<float>>(numChannels, static_cast<int>(end - start));
+            
+            auto result = renderer.renderChunk(*reader, start, end, job->preroll, *buffer);
+            if( result.failed() )
+            {
+                job->fail(juce::Result::fail(job->input.getFileName() + ": " + result.getErrorMessage()));
+                return;
+            }
+            
+            stats.add(renderer.getLastStats());
+            
+            auto chunkGainReductions = renderer.getLastGainReductions();
+            for( size_t band = 0; band < gainReductions.size(); ++band )
+            {
+                gainReductions[band] = juce::jmin(gainReductions[band], chunkGainReductions[band]);
+            }
+            
+            job->finish(chunk, std::move(buffer));
+        }
+    }
+    
+    OfflineRenderer renderer;
+    const int index;
+    
+    // for the last render
+    RenderStats stats;
+    std::array<float, Params::NumBands> gainReductions {};
+private:
+    Render* job { nullptr };
+};
+
+//==============================================================================
+ChunkedRenderer::ChunkedRenderer(const RenderSettings& settingsToUse, int numWorkers)
+    : settings(settingsToUse)
+{
+    jassert(numWorkers > 0);
+    jassert(settings.chunkSeconds > 0.0 && settings.prerollSeconds >= 0.0);
+    
+    for( int i = 0; i < numWorkers; ++i )
+    {
+        workers.add(new Worker(settings, i));
+    }
+}
+
+ChunkedRenderer::~ChunkedRenderer()
+{
+    for( auto* worker : workers )
+        worker->stopThread(-1);
+}
+
+juce::Result ChunkedRenderer::render(const juce::File& input, const juce::File& output)
+{
+    auto wallStart = juce::Time::getHighResolutionTicks();
+    
+    auto& first = workers.getFirst()->renderer;
+    auto reader = first.createReaderFor(input);
+    if( reader == nullptr )
+        return juce::Result::fail("can't read " + input.getFullPathName());
+    
+    auto numSamples = reader->lengthInSamples;
+    auto sampleRate = reader->sampleRate;
+    auto preroll = static_cast<juce::int64>(settings.prerollSeconds * sampleRate);
+    
+    // at least four chunks a worker so the stealing has something to even
+    // out, but never so short that the preroll is most of the work
+    auto chunkSize = static_cast<juce::int64>(settings.chunkSeconds * sampleRate);
+    chunkSize = juce::jmin(chunkSize, numSamples / (workers.size() * 4));
+    chunkSize = juce::jmax(chunkSize, preroll * 4, static_cast<juce::int64>(settings.blockSize));
+    
+    // not worth splitting
+    if( numSamples <= chunkSize )
+    {
+        auto result = first.render(input, output);
+        if( result.failed() )
+            return result;
+        
+        lastStats = first.getLastStats();
+        lastWallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - wallStart);
+        lastNumChunks = 1;
+        lastNumSteals = 0;
+        lastGainReductions = first.getLastGainReductions();
+        return result;
+    }
+    
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    auto result = first.createWriterFor(output, *reader, writer);
+    if( result.failed() )
+        return result;
+    
+    Render job(input, numSamples, chunkSize, preroll, workers.size());
+    
+    for( auto* worker : workers )
+        worker->start(job);
+    
+    // chunks are written in order as they come in, the scheduler hands them
+    // out roughly in order so few of them wait here at any time
+    for( int chunk = 0; chunk < job.numChunks && result.wasOk(); ++chunk )
+    {
+        auto buffer = job.waitFor(chunk);
+        if( buffer == nullptr )
+            result = job.getError();
+        else if( ! writer->writeFromAudioSampleBuffer(*buffer, 0, buffer->getNumSamples()) )
+            result = juce::Result::fail("error writing " + output.getFullPathName());
+    }
+    
+    for( auto* worker : workers )
+        worker->stopThread(-1);
+    
+    if( result.failed() )
+        return result;
+    
+    lastStats = {};
+    lastStats.numFiles = 1;
+    lastGainReductions.fill(0.f);
+    
+    for( auto* worker : workers )
+    {
+        lastStats.add(worker->stats);
+        
+        for( size_t band = 0; band < lastGainReductions.size(); ++band )
+        {
+            lastGainReductions[band] = juce::jmin(lastGainReductions[band], worker->gainReductions[band]);
+        }
+    }
+    
+    lastWallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - wallStart);
+    lastNumChunks = job.numChunks;
+    lastNumSteals = job.scheduler.getNumSteals();
+    
+    return result;
+}
+
+juce::Result ChunkedRenderer::verify(const juce::File& input, const juce::File& chunkedOutput, float& maxDifference)
+{
+    maxDifference = 0.f;
+    
+    juce::TemporaryFile sequentialOutput(chunkedOutput);
+    
+    auto& first = workers.getFirst()->renderer;
+    auto result = first.render(input, sequentialOutput.getFile());
+    if( result.failed() )
+        return result;
+    
+    auto sequential = first.createReaderFor(sequentialOutput.getFile());
+    auto chunked =    first.createReaderFor(chunkedOutput);
+    if( sequential == nullptr || chunked == nullptr )
+        return juce::Result::fail("can't read the renders back");
+    
+    if( sequential->lengthInSamples != chunked->lengthInSamples || sequential->numChannels != chunked->numChannels )
+        return juce::Result::fail("the chunked render has a different length or channel count");
+    
+    auto numChannels = static_cast<int>(sequential->numChannels);
+    juce::AudioBuffer<float> expected(numChannels, settings.blockSize), actual(numChannels, settings.blockSize);
+    
+    for( juce::int64 position = 0; position < sequential->lengthInSamples; position += settings.blockSize )
+    {
+        auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(settings.blockSize),
+                                                      sequential->lengthInSamples - position));
+        
+        sequential->read(&expected, 0, numSamples, position, true, true);
+        chunked->read(&actual, 0, numSamples, position, true, true);
+        
+        for( int channel = 0; channel < numChannels; ++channel )
+        {
+            // actual becomes the difference
+            juce::FloatVectorOperations::subtract(actual.getWritePointer(channel), expected.getReadPointer(channel), numSamples);
+            maxDifference = juce::jmax(maxDifference, actual.getMagnitude(channel, 0, numSamples));
+        }
+    }
+    
+    if( maxDifference > verifyTolerance )
+        return juce::Result::fail("the chunked render differs by " + juce::String(juce::Decibels::gainToDecibels(maxDifference), 1)
+                                  + " dBFS, more than the " + juce::String(juce::Decibels::gainToDecibels(verifyTolerance), 1)
+                                  + " dBFS tolerance");
+    
+    return juce::Result::ok();
+}
@@ -0,0 +1,77 @@
+/*
+ ==============================================================================
+ 
+ ChunkedRenderer.h
+ Created: 9 Oct 2026 9:48:05am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+//==============================================================================
+/*
+ Renders one long file on several cores at once.
+ 
+ The file is cut into chunks that a pool of workers, each with its own
+ processor, pull from a WorkStealingScheduler. A chunk is rendered from a
+ reset processor that first runs over the preroll before it, and the calling
+ thread writes the chunks out in order as they finish.
+ 
+ How close this gets to a sequential render depends on the preroll covering
+ everything in the processor that remembers the past:
+ 
+ - the linear phase FIRs need the kernel length, ~170 ms,
+ - the lookahead delay needs at most 10 ms,
+ - the compressor envelopes decay with the release time constant, 80 ms at
+   the longest release of 500 ms, and the LR4 crossovers settle faster.
+ 
+ With the default 4 s preroll the state left over from the reset is down by
+ e^-50 by the time a chunk starts, which is far below float resolution. What
+ remains is float rounding, mostly from the convolutions partitioning a chunk
+ differently from the whole file, and the rounding of the output format. A
+ chunked render is within verifyTolerance (-80 dBFS, about three 16 bit
+ steps) of a sequential one, and verify() checks exactly that.
+ */
+struct ChunkedRenderer
+{
+    static constexpr float verifyTolerance = 1.0e-4f;
+    
+    ChunkedRenderer(const RenderSettings& settingsToUse, int numWorkers);
+    ~ChunkedRenderer();
+    
+    juce::Result render(const juce::File& input, const juce::File& output);
+    
+    /*
+     Renders input again sequentially and compares that with chunkedOutput.
+     Fails if they differ by more than verifyTolerance anywhere.
+     */
+    juce::Result verify(const juce::File& input, const juce::File& chunkedOutput, float& maxDifference);
+    
+    // processSeconds is the time spent in processBlock on all workers,
+    // preroll included, so the real time factor is per worker
+    const RenderStats& getLastStats() const { return lastStats; }
+    double getLastWallSeconds() const { return lastWallSeconds; }
+    int getLastNumChunks() const { return lastNumChunks; }
+    int getLastNumSteals() const { return lastNumSteals; }
+    
+    std::array<float, Params::NumBands> getLastGainReductions() const { return lastGainReductions; }
+private:
+    struct Render;
+    struct Worker;
+    
+    RenderSettings settings;
+    juce::OwnedArray<Worker> workers;
+    
+    RenderStats lastStats;
+    double lastWallSeconds { 0.0 };
+    int lastNumChunks { 0 };
+    int lastNumSteals { 0 };
+    std::array<float, Params::NumBands> lastGainReductions {};
+    
+    JUCE_DECLARE_NON_COPYABLE(ChunkedRenderer)
+};
@@ -0,0 +1,376 @@
+/*
+ ==============================================================================
+ 
+ Main.cpp
+ Created: 8 Oct 2026 10:47:19am
+ Author:  Keith Hetrick
+ 
+ SimpleMBCompRender: runs audio files through the compressor without a host.
+ 
+ ==============================================================================
+ */
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <iostream>
+#include "ChunkedRenderer.h"
+#include "OfflineRenderer.h"
+
+namespace
+{
+struct Options
+{
+    RenderSettings settings;
+    juce::Array<juce::File> inputs;
+    juce::File output;          // only with a single input
+    juce::File outputDirectory; // next to each input when not set
+    juce::String suffix { "_mbc" };
+    int numJobs { juce::SystemStats::getNumCpus() };
+    bool verify { false };
+};
+
+struct Job
+{
+    juce::File input, output;
+};
+
+void printUsage()
+{
+    std::cout << "usage: SimpleMBCompRender [options] input..." << std::endl
+              << std::endl
+              << "  --preset <file>       processor state, as saved by a host or as XML" << std::endl
+              << "  -o, --output <file>   output file, for a single input" << std::endl
+              << "  --output-dir <dir>    where outputs go, next to the inputs by default" << std::endl
+              << "  --suffix <text>       appended to output names, default _mbc" << std::endl
+              << "  --block-size <n>      samples per processBlock call, default 512" << std::endl
+              << "  -j, --jobs <n>        files rendered at once, default one per core" << std::endl
+              << std::endl
+              << "A single input is cut into chunks that are rendered on all jobs at once." << std::endl
+              << std::endl
+              << "  --chunk-seconds <s>   longest chunk, default 60" << std::endl
+              << "  --preroll <s>         audio run through before each chunk, default 4" << std::endl
+              << "  --verify              also render sequentially and compare" << std::endl;
+}
+
+juce::Result parseOptions(const juce::StringArray& args, Options& options)
+{
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+    
+    for( int i = 0; i < args.size(); ++i )
+    {
+        const auto& arg = args[i];
+        
+        if( ! arg.startsWith("-") )
+        {
+            options.inputs.add(cwd.getChildFile(arg));
+            continue;
+        }
+        
+        if( arg == "--verify" )
+        {
+            options.verify = true;
+            continue;
+        }
+        
+        if( i + 1 >= args.size() )
+            return juce::Result::fail(arg + " needs a value");
+        
+        const auto& value = args[++i];
+        
+        if( arg == "--preset" )
+        {
+            auto result = OfflineRenderer::loadPreset(cwd.getChildFile(value), options.settings.preset);
+            if( result.failed() )
+                return result;
+        }
+        else if( arg == "-o" || arg == "--output" )
+        {
+            options.output = cwd.getChildFile(value);
+        }
+        else if( arg == "--output-dir" )
+        {
+            options.outputDirectory = cwd.getChildFile(value);
+        }
+        else if( arg == "--suffix" )
+        {
+            options.suffix = value;
+        }
+        else if( arg == "--block-size" )
+        {
+            options.settings.blockSize = value.getIntValue();
+            if( options.settings.blockSize <= 0 )
+                return juce::Result::fail("--block-size must be positive");
+        }
+        else if( arg == "-j" || arg == "--jobs" )
+        {
+            options.numJobs = value.getIntValue();
+            if( options.numJobs <= 0 )
+                return juce::Result::fail("--jobs must be positive");
+        }
+        else if( arg == "--chunk-seconds" )
+        {
+            options.settings.chunkSeconds = value.getDoubleValue();
+            if( options.settings.chunkSeconds <= 0.0 )
+                return juce::Result::fail("--chunk-seconds must be positive");
+        }
+        else if( arg == "--preroll" )
+        {
+            options.settings.prerollSeconds = value.getDoubleValue();
+            if( options.settings.prerollSeconds < 0.0 )
+                return juce::Result::fail("--preroll can't be negative");
+        }
+        else
+        {
+            return juce::Result::fail("unknown option " + arg);
+        }
+    }
+    
+    if( options.inputs.isEmpty() )
+        return juce::Result::fail("no input files");
+    
+    if( options.output != juce::File() && options.inputs.size() > 1 )
+        return juce::Result::fail("--output needs exactly one input, use --output-dir");
+    
+    return juce::Result::ok();
+}
+
+juce::Array<Job> makeJobs(const Options& options)
+{
+    juce::Array<Job> jobs;
+    
+    for( const auto& input : options.inputs )
+    {
+        if( options.output != juce::File() )
+        {
+            jobs.add({ input, options.output });
+            continue;
+        }
+        
+        auto directory = options.outputDirectory != juce::File() ? options.outputDirectory
+                                                                 : input.getParentDirectory();
+        auto name = input.getFileNameWithoutExtension() + options.suffix + input.getFileExtension();
+        jobs.add({ input, directory.getChildFile(name) });
+    }
+    
+    return jobs;
+}
+
+juce::String formatSeconds(double seconds)
+{
+    return juce::String(seconds, 2) + " s";
+}
+
+//==============================================================================
+// prints results as workers finish them, one line at a time
+struct Reporter
+{
+    void report(const Job& job, const juce::Result& result, const OfflineRenderer& renderer)
+    {
+        const juce::ScopedLock sl(lock);
+        
+        if( result.failed() )
+        {
+            ++numFailed;
+            std::cerr << "FAILED " << job.input.getFileName() << ": " << result.getErrorMessage() << std::endl;
+            return;
+        }
+        
+        const auto& stats = renderer.getLastStats();
+        auto line = job.output.getFileName()
+                  + ": " + formatSeconds(stats.audioSeconds)
+                  + " in " + formatSeconds(stats.processSeconds)
+                  + ", " + juce::String(stats.getRealtimeFactor(), 1) + "x realtime, GR";
+        
+        for( auto gainReduction : renderer.getLastGainReductions() )
+        {
+            line << " " << juce::String(gainReduction, 1);
+        }
+        
+        std::cout << line << " dB" << std::endl;
+    }
+    
+    int getNumFailed() const { return numFailed; }
+private:
+    juce::CriticalSection lock;
+    int numFailed { 0 };
+};
+
+//==============================================================================
+// one processor per worker, so workers never share any DSP state
+struct RenderWorker : juce::Thread
+{
+    RenderWorker(const RenderSettings& settings,
+                 const juce::Array<Job>& jobsToRender,
+                 std::atomic<int>& next,
+                 Reporter& reporterToUse)
+        : juce::Thread("SimpleMBCompRender worker"),
+          renderer(settings),
+          jobs(jobsToRender),
+          nextJob(next),
+          reporter(reporterToUse)
+    {
+    }
+    
+    void run() override
+    {
+        while( ! threadShouldExit() )
+        {
+            auto index = nextJob.fetch_add(1);
+            if( index >= jobs.size() )
+                break;
+            
+            const auto& job = jobs.getReference(index);
+            auto result = renderer.render(job.input, job.output);
+            reporter.report(job, result, renderer);
+        }
+    }
+    
+    const RenderStats& getTotalStats() const { return renderer.getTotalStats(); }
+private:
+    OfflineRenderer renderer;
+    const juce::Array<Job>& jobs;
+    std::atomic<int>& nextJob;
+    Reporter& reporter;
+};
+
+void printSummary(const RenderStats& total, double wallSeconds, int numWorkers)
+{
+    std::cout << std::endl
+              << total.numFiles << " files, " << formatSeconds(total.audioSeconds) << " of audio"
+              << " in " << formatSeconds(wallSeconds) << " on " << numWorkers << " workers";
+    
+    if( wallSeconds > 0.0 )
+        std::cout << ", " << juce::String(total.audioSeconds / wallSeconds, 1) << "x realtime overall";
+    
+    std::cout << std::endl
+              << "per worker: " << juce::String(total.getRealtimeFactor(), 1) << "x realtime" << std::endl;
+    
+    auto profiled = total.stages.getTotalSeconds();
+    if( profiled <= 0.0 )
+        return;
+    
+    std::cout << std::endl << "processBlock stages:" << std::endl;
+    for( int stage = 0; stage < StageProfiler::NumStages; ++stage )
+    {
+        auto seconds = total.stages.getSeconds(stage);
+        std::cout << "  " << juce::String(StageProfiler::getStageName(stage)).paddedRight(' ', 12)
+                  << formatSeconds(seconds).paddedLeft(' ', 12)
+                  << juce::String(100.0 * seconds / profiled, 1).paddedLeft(' ', 8) << " %" << std::endl;
+    }
+}
+
+//==============================================================================
+int renderChunked(const Options& options, const Job& job)
+{
+    ChunkedRenderer renderer(options.settings, options.numJobs);
+    
+    auto result = renderer.render(job.input, job.output);
+    if( result.failed() )
+    {
+        std::cerr << "FAILED " << job.input.getFileName() << ": " << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+    
+    const auto& stats = renderer.getLastStats();
+    auto line = job.output.getFileName()
+              + ": " + juce::String(renderer.getLastNumChunks()) + " chunks, "
+              + juce::String(renderer.getLastNumSteals()) + " stolen, GR";
+    
+    for( auto gainReduction : renderer.getLastGainReductions() )
+    {
+        line << " " << juce::String(gainReduction, 1);
+    }
+    
+    std::cout << line << " dB" << std::endl;
+    printSummary(stats, renderer.getLastWallSeconds(), options.numJobs);
+    
+    if( ! options.verify )
+        return 0;
+    
+    auto maxDifference = 0.f;
+    result = renderer.verify(job.input, job.output, maxDifference);
+    
+    std::cout << std::endl << "largest difference from a sequential render: "
+              << juce::String(juce::Decibels::gainToDecibels(maxDifference, -200.f), 1) << " dBFS" << std::endl;
+    
+    if( result.failed() )
+    {
+        std::cerr << "FAILED " << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    
+    juce::StringArray args;
+    for( int i = 1; i < argc; ++i )
+    {
+        args.add(juce::CharPointer_UTF8(argv[i]));
+    }
+    
+    if( args.isEmpty() || args.contains("-h") || args.contains("--help") )
+    {
+        printUsage();
+        return 0;
+    }
+    
+    Options options;
+    auto result = parseOptions(args, options);
+    if( result.failed() )
+    {
+        std::cerr << result.getErrorMessage() << std::endl << std::endl;
+        printUsage();
+        return 1;
+    }
+    
+    auto jobs = makeJobs(options);
+    
+    if( jobs.size() == 1 && options.numJobs > 1 )
+        return renderChunked(options, jobs.getFirst());
+    
+    auto numWorkers = juce::jmin(options.numJobs, jobs.size());
+    
+    std::atomic<int> nextJob { 0 };
+    Reporter reporter;
+    
+    // the processors are created here, on the message thread, and only their
+    // rendering runs on the workers
+    juce::OwnedArray<RenderWorker> workers;
+    for( int i = 0; i < numWorkers; ++i )
+    {
+        workers.add(new RenderWorker(options.settings, jobs, nextJob, reporter));
+    }
+    
+    auto start = juce::Time::getHighResolutionTicks();
+    
+    if( numWorkers == 1 )
+    {
+        workers[0]->run();
+    }
+    else
+    {
+        for( auto* worker : workers )
+            worker->startThread();
+        
+        for( auto* worker : workers )
+            worker->waitForThreadToExit(-1);
+    }
+    
+    auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    
+    RenderStats total;
+    for( auto* worker : workers )
+    {
+        total.add(worker->getTotalStats());
+    }
+    
+    printSummary(total, wallSeconds, numWorkers);
+    
+    return reporter.getNumFailed() > 0 ? 1 : 0;
+}
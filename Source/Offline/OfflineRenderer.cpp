@@ -0,0 +1,258 @@
+/*
+ ==============================================================================
+ 
+ OfflineRenderer.cpp
+ Created: 8 Oct 2026 10:02:51am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#include "OfflineRenderer.h"
+
+OfflineRenderer::OfflineRenderer(const RenderSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+    jassert(settings.blockSize > 0);
+    formatManager.registerBasicFormats();
+}
+
+juce::Result OfflineRenderer::loadPreset(const juce::File& file, juce::MemoryBlock& preset)
+{
+    if( ! file.existsAsFile() )
+        return juce::Result::fail("no preset at " + file.getFullPathName());
+    
+    // XML is converted to the same binary form getStateInformation() writes
+    if( auto xml = juce::parseXML(file) )
+    {
+        auto tree = juce::ValueTree::fromXml(*xml);
+        if( ! tree.isValid() )
+            return juce::Result::fail(file.getFileName() + " isn't a processor state");
+        
+        preset.reset();
+        juce::MemoryOutputStream mos(preset, false);
+        tree.writeToStream(mos);
+        return juce::Result::ok();
+    }
+    
+    if( ! file.loadFileAsData(preset) || ! juce::ValueTree::readFromData(preset.getData(), preset.getSize()).isValid() )
+        return juce::Result::fail(file.getFileName() + " isn't a processor state");
+    
+    return juce::Result::ok();
+}
+
+bool OfflineRenderer::prepare(int numChannels, double sampleRate)
+{
+    auto channelSet = SimpleMBCompAudioProcessor::getMainLayout(numChannels);
+    
+    // no sidechain offline, every other input bus stays disabled
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+    
+    for( int bus = 1; bus < processor.getBusCount(true); ++bus )
+        layout.inputBuses.add(juce::AudioChannelSet::disabled());
+    
+    if( ! processor.setBusesLayout(layout) )
+        return false;
+    
+    processor.releaseResources();
+    
+    if( settings.preset.getSize() > 0 )
+        processor.setStateInformation(settings.preset.getData(), static_cast<int>(settings.preset.getSize()));
+    
+    processor.setNonRealtime(true);
+    processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+    processor.prepareToPlay(sampleRate, settings.blockSize);
+    processor.reset();
+    processor.clearMeterHistory();
+    
+    preparedChannels = numChannels;
+    preparedSampleRate = sampleRate;
+    
+    return true;
+}
+
+bool OfflineRenderer::processRange(juce::AudioFormatReader& reader,
+                                   juce::int64 start,
+                                   juce::int64 end,
+                                   juce::int64 skip,
+                                   const BlockWriter& write)
+{
+    auto numChannels = static_cast<int>(reader.numChannels);
+    juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+    juce::MidiBuffer midi;
+    
+    juce::int64 processTicks = 0;
+    auto ok = true;
+    
+    for( auto position = start; position < end; position += settings.blockSize )
+    {
+        auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(settings.blockSize), end - position));
+        
+        // past the end of the file the reader fills in silence, which flushes
+        // the latency out of the processor
+        reader.read(&buffer, 0, numSamples, position, true, true);
+        
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+        
+        auto blockStart = juce::Time::getHighResolutionTicks();
+        processor.processBlock(block, midi);
+        processTicks += juce::Time::getHighResolutionTicks() - blockStart;
+        
+        // nobody else drains the meter history offline
+        processor.updateMeterHistory();
+        
+        auto skipped = static_cast<int>(juce::jmin(skip, static_cast<juce::int64>(numSamples)));
+        skip -= skipped;
+        
+        if( skipped < numSamples && ! write(block, skipped, numSamples - skipped) )
+        {
+            ok = false;
+            break;
+        }
+    }
+    
+    lastStats.processSeconds += juce::Time::highResolutionTicksToSeconds(processTicks);
+    return ok;
+}
+
+std::unique_ptr<juce::AudioFormatReader> OfflineRenderer::createReaderFor(const juce::File& input)
+{
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(input));
+}
+
+juce::Result OfflineRenderer::createWriterFor(const juce::File& output,
+                                              const juce::AudioFormatReader& source,
+                                              std::unique_ptr<juce::AudioFormatWriter>& writer)
+{
+    auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+    if( format == nullptr )
+        return juce::Result::fail("no audio format for " + output.getFileName());
+    
+    auto bitDepths = format->getPossibleBitDepths();
+    auto bitsPerSample = bitDepths.contains(static_cast<int>(source.bitsPerSample)) ? static_cast<int>(source.bitsPerSample)
+                                                                                    : bitDepths.getLast();
+    
+    output.deleteFile();
+    auto stream = output.createOutputStream();
+    if( stream == nullptr )
+        return juce::Result::fail("can't write " + output.getFullPathName());
+    
+    writer.reset(format->createWriterFor(stream.get(),
+                                         source.sampleRate,
+                                         source.numChannels,
+                                         bitsPerSample,
+                                         source.metadataValues,
+                                         0));
+    if( writer == nullptr )
+        return juce::Result::fail("can't write " + output.getFileName() + " in that format");
+    
+    // the writer owns the stream now
+    stream.release();
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::render(const juce::File& input, const juce::File& output)
+{
+    auto reader = createReaderFor(input);
+    if( reader == nullptr )
+        return juce::Result::fail("can't read " + input.getFullPathName());
+    
+    auto sampleRate = reader->sampleRate;
+    
+    if( ! prepare(static_cast<int>(reader->numChannels), sampleRate) )
+        return juce::Result::fail(input.getFileName() + ": files with more than " + juce::String(SimpleMBCompAudioProcessor::maxMainChannels) + " channels are not supported");
+    
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    auto result = createWriterFor(output, *reader, writer);
+    if( result.failed() )
+        return result;
+    
+    auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+    
+    lastStats = {};
+    lastStats.numFiles = 1;
+    lastStats.audioSeconds = static_cast<double>(reader->lengthInSamples) / sampleRate;
+    processor.setStageProfiler(&lastStats.stages);
+    
+    auto ok = processRange(*reader, 0, reader->lengthInSamples + latency, latency,
+                           [&writer](const juce::AudioBuffer<float>& block, int startSample, int numSamples)
+                           {
+                               return writer->writeFromAudioSampleBuffer(block, startSample, numSamples);
+                           });
+    
+    processor.setStageProfiler(nullptr);
+    
+    if( ! ok )
+        return juce::Result::fail("error writing " + output.getFullPathName());
+    
+    totalStats.add(lastStats);
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::renderChunk(juce::AudioFormatReader& reader,
+                                          juce::int64 start,
+                                          juce::int64 end,
+                                          juce::int64 preroll,
+                                          juce::AudioBuffer<float>& output)
+{
+    jassert(start >= 0 && start < end && preroll >= 0);
+    jassert(output.getNumSamples() >= end - start);
+    
+    auto numChannels = static_cast<int>(reader.numChannels);
+    jassert(output.getNumChannels() == numChannels);
+    
+    // preparing designs the linear phase kernels, so it's only done once per
+    // format and every other chunk just resets
+    if( numChannels != preparedChannels || reader.sampleRate != preparedSampleRate )
+    {
+        if( ! prepare(numChannels, reader.sampleRate) )
+            return juce::Result::fail("files with more than " + juce::String(SimpleMBCompAudioProcessor::maxMainChannels) + " channels are not supported");
+    }
+    else
+    {
+        processor.reset();
+        processor.clearMeterHistory();
+    }
+    
+    auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+    auto prerollStart = juce::jmax(juce::int64(0), start - preroll);
+    
+    lastStats = {};
+    lastStats.audioSeconds = static_cast<double>(end - start) / reader.sampleRate;
+    processor.setStageProfiler(&lastStats.stages);
+    
+    auto written = 0;
+    processRange(reader, prerollStart, end + latency, start - prerollStart + latency,
+                 [&output, &written, numChannels](const juce::AudioBuffer<float>& block, int startSample, int numSamples)
+                 {
+                     for( int channel = 0; channel < numChannels; ++channel )
+                     {
+                         output.copyFrom(channel, written, block, channel, startSample, numSamples);
+                     }
+                     
+                     written += numSamples;
+                     return true;
+                 });
+    
+    processor.setStageProfiler(nullptr);
+    jassert(written == end - start);
+    
+    totalStats.add(lastStats);
+    return juce::Result::ok();
+}
+
+std::array<float, Params::NumBands> OfflineRenderer::getLastGainReductions() const
+{
+    std::array<float, Params::NumBands> gainReductions;
+    
+    for( size_t band = 0; band < gainReductions.size(); ++band )
+    {
+        const auto& history = processor.getMeterHistory(band);
+        auto range = history.getRange(0, history.getNumFrames());
+        gainReductions[band] = range.isEmpty ? 0.f : range.minGainReductionDb;
+    }
+    
+    return gainReductions;
+}
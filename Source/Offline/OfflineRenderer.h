@@ -0,0 +1,120 @@
+/*
+ ==============================================================================
+ 
+ OfflineRenderer.h
+ Created: 8 Oct 2026 10:02:51am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "../PluginProcessor.h"
+
+//==============================================================================
+struct RenderSettings
+{
+    juce::MemoryBlock preset;   // processor state, empty for the defaults
+    int blockSize { 512 };
+    
+    // chunked renders, see ChunkedRenderer
+    double chunkSeconds { 60.0 };
+    double prerollSeconds { 4.0 };
+};
+
+struct RenderStats
+{
+    int numFiles { 0 };
+    double audioSeconds { 0.0 };
+    double processSeconds { 0.0 };  // inside processBlock only
+    StageProfiler stages;
+    
+    double getRealtimeFactor() const
+    {
+        return processSeconds > 0.0 ? audioSeconds / processSeconds : 0.0;
+    }
+    
+    void add(const RenderStats& other)
+    {
+        numFiles +=       other.numFiles;
+        audioSeconds +=   other.audioSeconds;
+        processSeconds += other.processSeconds;
+        stages.add(other.stages);
+    }
+};
+
+//==============================================================================
+/*
+ Runs audio files through a SimpleMBCompAudioProcessor, the way a host would
+ bounce them.
+ 
+ The processor is created once and reused for every file: it is re-prepared
+ for the file's sample rate and channel count, the preset is applied again,
+ and its state is reset. The latency it reports is trimmed from the start of
+ the output, and the tail is flushed with silence, so the output lines up
+ with the input sample for sample.
+ 
+ One renderer is meant to be driven by one thread.
+ */
+struct OfflineRenderer
+{
+    explicit OfflineRenderer(const RenderSettings& settingsToUse);
+    
+    // loads a preset saved as processor state, either binary or as XML
+    static juce::Result loadPreset(const juce::File& file, juce::MemoryBlock& preset);
+    
+    juce::Result render(const juce::File& input, const juce::File& output);
+    
+    std::unique_ptr<juce::AudioFormatReader> createReaderFor(const juce::File& input);
+    
+    // a writer in output's format with source's channels, rate and, if the
+    // format allows it, bit depth
+    juce::Result createWriterFor(const juce::File& output,
+                                 const juce::AudioFormatReader& source,
+                                 std::unique_ptr<juce::AudioFormatWriter>& writer);
+    
+    /*
+     Renders samples [start, end) of reader into output, which must hold
+     end - start samples, with the latency already taken out. The processor
+     is reset and starts on the preroll samples before start, so its filters
+     and envelopes have settled by the time the chunk itself begins.
+     */
+    juce::Result renderChunk(juce::AudioFormatReader& reader,
+                             juce::int64 start,
+                             juce::int64 end,
+                             juce::int64 preroll,
+                             juce::AudioBuffer<float>& output);
+    
+    // what the last successful render did, and the totals over all of them
+    const RenderStats& getLastStats()  const { return lastStats; }
+    const RenderStats& getTotalStats() const { return totalStats; }
+    
+    // strongest gain reduction of each band in the last render
+    std::array<float, Params::NumBands> getLastGainReductions() const;
+private:
+    RenderSettings settings;
+    juce::AudioFormatManager formatManager;
+    SimpleMBCompAudioProcessor processor;
+    
+    RenderStats lastStats, totalStats;
+    
+    int preparedChannels { 0 };
+    double preparedSampleRate { 0.0 };
+    
+    bool prepare(int numChannels, double sampleRate);
+    
+    using BlockWriter = std::function<bool(const juce::AudioBuffer<float>& block, int startSample, int numSamples)>;
+    
+    // processes reader samples [start, end), passing on what comes out once
+    // the first skip samples are gone
+    bool processRange(juce::AudioFormatReader& reader,
+                      juce::int64 start,
+                      juce::int64 end,
+                      juce::int64 skip,
+                      const BlockWriter& write);
+    
+    JUCE_DECLARE_NON_COPYABLE(OfflineRenderer)
+};
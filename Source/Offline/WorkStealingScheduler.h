@@ -0,0 +1,118 @@
+/*
+ ==============================================================================
+ 
+ WorkStealingScheduler.h
+ Created: 9 Oct 2026 9:12:37am
+ Author:  Keith Hetrick
+ 
+ ==============================================================================
+ */
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+//==============================================================================
+/*
+ Hands out task indices 0...numTasks - 1 to a fixed set of workers.
+ 
+ Every worker gets its own queue, dealt round robin, so worker w starts with
+ tasks w, w + numWorkers, w + 2 * numWorkers... and takes them lowest first.
+ A worker whose queue runs dry steals the highest task of the fullest queue.
+ Tasks therefore finish roughly in order, which keeps whatever has to wait
+ for an earlier task small, and stealing only starts near the end, when the
+ workers that got the slow tasks are left with the tail.
+ 
+ A queue is only ever locked by its owner and the odd thief, so a spin lock
+ per queue is plenty.
+ */
+struct WorkStealingScheduler
+{
+    WorkStealingScheduler(int numTasks, int numWorkers)
+        : queues(static_cast<size_t>(numWorkers))
+    {
+        jassert(numWorkers > 0);
+        
+        for( int task = 0; task < numTasks; ++task )
+        {
+            queues[static_cast<size_t>(task % numWorkers)].tasks.push_back(task);
+        }
+    }
+    
+    // false once there is nothing left anywhere
+    bool getNextTask(int worker, int& task)
+    {
+        if( queues[static_cast<size_t>(worker)].popFront(task) )
+            return true;
+        
+        while( true )
+        {
+            Queue* victim = nullptr;
+            size_t mostTasks = 0;
+            
+            for( auto& queue : queues )
+            {
+                auto size = queue.getSize();
+                if( size > mostTasks )
+                {
+                    mostTasks = size;
+                    victim = &queue;
+                }
+            }
+            
+            if( victim == nullptr )
+                return false;
+            
+            // someone else may have emptied it in the meantime
+            if( victim->popBack(task) )
+            {
+                ++numSteals;
+                return true;
+            }
+        }
+    }
+    
+    int getNumSteals() const { return numSteals.load(); }
+private:
+    struct Queue
+    {
+        juce::SpinLock lock;
+        std::deque<int> tasks;
+        
+        bool popFront(int& task)
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if( tasks.empty() )
+                return false;
+            
+            task = tasks.front();
+            tasks.pop_front();
+            return true;
+        }
+        
+        bool popBack(int& task)
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            if( tasks.empty() )
+                return false;
+            
+            task = tasks.back();
+            tasks.pop_back();
+            return true;
+        }
+        
+        size_t getSize()
+        {
+            const juce::SpinLock::ScopedLockType sl(lock);
+            return tasks.size();
+        }
+    };
+    
+    std::vector<Queue> queues;
+    std::atomic<int> numSteals { 0 };
+    
+    JUCE_DECLARE_NON_COPYABLE(WorkStealingScheduler)
+};
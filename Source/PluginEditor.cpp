@@ -17,6 +17,7 @@ ControlBar::ControlBar()
     analyzerButton.setToggleState(true, juce::NotificationType::dontSendNotification);
     addAndMakeVisible(analyzerButton);
     
+    addAndMakeVisible(cpuMeter);
     addAndMakeVisible(globalBypassButton);
 }
 
@@ -30,6 +31,9 @@ void ControlBar::resized()
     
     globalBypassButton.setBounds(bounds.removeFromRight(60)
                                  .withTrimmedTop(2));
+    
+    cpuMeter.setBounds(bounds.removeFromRight(130)
+                       .withTrimmedTop(4));
 }
 //==============================================================================
 SimpleMBCompAudioProcessorEditor::SimpleMBCompAudioProcessorEditor (SimpleMBCompAudioProcessor& p)
@@ -50,13 +54,26 @@ SimpleMBCompAudioProcessorEditor::SimpleMBCompAudioProcessorEditor (SimpleMBComp
         toggleGlobalBypassState();
     };
     
+    controlBar.cpuMeter.onReset = [this]()
+    {
+        audioProcessor.getDeadlineMonitor().reset();
+    };
+    
     addAndMakeVisible(controlBar);
     addAndMakeVisible(analyzer);
     addAndMakeVisible(globalControls);
     addAndMakeVisible(bandControls);
+#if SIMPLEMBCOMP_TRACE
+    addAndMakeVisible(traceView);
+#endif
     
     setSize (600, 500);
     
+    for( size_t i = 0; i < lastHistoryFrames.size(); ++i )
+    {
+        lastHistoryFrames[i] = audioProcessor.getMeterHistory(i).getNumFrames();
+    }
+    
     startTimer(60);
 }
 
@@ -139,23 +156,41 @@ void SimpleMBCompAudioProcessorEditor::resized()
     
     analyzer.setBounds(bounds.removeFromTop(216));
 //    overlay->setBounds(analyzer.getBounds());
+#if SIMPLEMBCOMP_TRACE
+    traceView.setBounds(analyzer.getBounds()
+                        .reduced(24, 14)
+                        .removeFromRight(190)
+                        .removeFromTop(traceView.getIdealHeight()));
+#endif
     
     globalControls.setBounds(bounds);
 }
 
 void SimpleMBCompAudioProcessorEditor::timerCallback()
 {
-    std::vector<float> values
+    audioProcessor.updateMeterHistory();
+    
+    std::vector<float> gainReductions;
+    for( size_t i = 0; i < audioProcessor.compressors.size(); ++i )
     {
-        audioProcessor.lowBandComp. getRMSInputLevelDb (),
-        audioProcessor.lowBandComp. getRMSOutputLevelDb(),
-        audioProcessor.midBandComp. getRMSInputLevelDb (),
-        audioProcessor.midBandComp. getRMSOutputLevelDb(),
-        audioProcessor.highBandComp.getRMSInputLevelDb (),
-        audioProcessor.highBandComp.getRMSOutputLevelDb()
-    };
+        // show the strongest reduction since the last tick rather than
+        // whatever the last block happened to be
+        const auto& history = audioProcessor.getMeterHistory(i);
+        auto range = history.getRange(lastHistoryFrames[i], history.getNumFrames());
+        lastHistoryFrames[i] = history.getNumFrames();
+        
+        gainReductions.push_back(range.isEmpty ? audioProcessor.compressors[i].getMeterReading().gainReductionDb
+                                               : range.minGainReductionDb);
+    }
+    
+    analyzer.update(gainReductions);
+    
+#if SIMPLEMBCOMP_TRACE
+    traceView.update();
+#endif
     
-    analyzer.update(values);
+    auto& deadlineMonitor = audioProcessor.getDeadlineMonitor();
+    controlBar.cpuMeter.update(deadlineMonitor.takePeakLoad(), deadlineMonitor.getStats());
     
     updateGlobalBypassButton();
 }
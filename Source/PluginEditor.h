@@ -15,7 +15,9 @@
 #include "GUI/CompressorBandControls.h"
 #include "GUI/UtilityComponents.h"
 #include "GUI/SpectrumAnalyzer.h"
+#include "GUI/CpuMeter.h"
 #include "GUI/CustomButtons.h"
+#include "GUI/TraceView.h"
 
 /**
  */
@@ -26,6 +28,7 @@ struct ControlBar : juce::Component
     void resized() override;
     
     AnalyzerButton analyzerButton;
+    CpuMeter cpuMeter;
     PowerButton globalBypassButton;
 };
 //==============================================================================
@@ -51,6 +54,9 @@ private:
     GlobalControls globalControls       { audioProcessor.apvts };
     CompressorBandControls bandControls { audioProcessor.apvts };
     SpectrumAnalyzer analyzer           { audioProcessor };
+#if SIMPLEMBCOMP_TRACE
+    TraceView traceView                 { audioProcessor.getTrace() };
+#endif
     
     void toggleGlobalBypassState();
     
@@ -58,5 +64,8 @@ private:
     
     void updateGlobalBypassButton();
     
+    // how much of each band's meter history has been shown already
+    std::array<juce::int64, Params::NumBands> lastHistoryFrames {};
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleMBCompAudioProcessorEditor)
 };
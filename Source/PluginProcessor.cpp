@@ -7,8 +7,9 @@
  */
 
 #include "PluginProcessor.h"
+#if ! SIMPLEMBCOMP_HEADLESS
 #include "PluginEditor.h"
-#include "DSP/Params.h"
+#endif
 
 //==============================================================================
 SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
@@ -17,6 +18,7 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
                   .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                  .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
                   .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
 #endif
@@ -32,63 +34,67 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
         jassert(param != nullptr);
     };
     
-    floatHelper(lowBandComp.attack,     Names::Attack_Low_Band);
-    floatHelper(lowBandComp.release,    Names::Release_Low_Band);
-    floatHelper(lowBandComp.threshold,  Names::Threshold_Low_Band);
-    
-    floatHelper(midBandComp.attack,     Names::Attack_Mid_Band);
-    floatHelper(midBandComp.release,    Names::Release_Mid_Band);
-    floatHelper(midBandComp.threshold,  Names::Threshold_Mid_Band);
-    
-    floatHelper(highBandComp.attack,    Names::Attack_High_Band);
-    floatHelper(highBandComp.release,   Names::Release_High_Band);
-    floatHelper(highBandComp.threshold, Names::Threshold_High_Band);
-    
     auto choiceHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
     {
         param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
         jassert(param != nullptr);
     };
     
-    choiceHelper(lowBandComp.ratio,     Names::Ratio_Low_Band);
-    choiceHelper(midBandComp.ratio,     Names::Ratio_Mid_Band);
-    choiceHelper(highBandComp.ratio,    Names::Ratio_High_Band);
-    
     auto boolHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
     {
         param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
         jassert(param != nullptr);
     };
     
-    boolHelper(lowBandComp.bypassed,    Names::Bypassed_Low_Band);
-    boolHelper(midBandComp.bypassed,    Names::Bypassed_Mid_Band);
-    boolHelper(highBandComp.bypassed,   Names::Bypassed_High_Band);
-    
-    boolHelper(lowBandComp.mute,        Names::Mute_Low_Band);
-    boolHelper(midBandComp.mute,        Names::Mute_Mid_Band);
-    boolHelper(highBandComp.mute,       Names::Mute_High_Band);
-    
-    boolHelper(lowBandComp.solo,        Names::Solo_Low_Band);
-    boolHelper(midBandComp.solo,        Names::Solo_Mid_Band);
-    boolHelper(highBandComp.solo,       Names::Solo_High_Band);
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        auto& comp = compressors[band];
+        
+        floatHelper (comp.attack,       forBand(Names::Attack_Band,    band));
+        floatHelper (comp.release,      forBand(Names::Release_Band,   band));
+        floatHelper (comp.threshold,    forBand(Names::Threshold_Band, band));
+        
+        choiceHelper(comp.ratio,        forBand(Names::Ratio_Band,     band));
+        
+        boolHelper  (comp.bypassed,     forBand(Names::Bypassed_Band,  band));
+        boolHelper  (comp.mute,         forBand(Names::Mute_Band,      band));
+        boolHelper  (comp.solo,         forBand(Names::Solo_Band,      band));
+        
+        floatHelper (comp.knee,         forBand(Names::Knee_Band,      band));
+        choiceHelper(comp.engine,       forBand(Names::Engine_Band,    band));
+        floatHelper (comp.lookahead,    forBand(Names::Lookahead_Band, band));
+        choiceHelper(comp.detector,     forBand(Names::Detector_Band,  band));
+        
+        comp.listenForSettingsChanges();
+    }
     
-    floatHelper(lowMidCrossover,        Names::Low_Mid_Crossover_Freq);
-    floatHelper(midHighCrossover,       Names::Mid_High_Crossover_Freq);
+    for( size_t i = 0; i < NumCrossovers; ++i )
+    {
+        floatHelper(crossoverFreqs[i],  forCrossover(i));
+        crossoverRamps[i].setParameter(crossoverFreqs[i]);
+    }
     
     floatHelper(inputGainParam,         Names::Gain_In);
     floatHelper(outputGainParam,        Names::Gain_Out);
     
-    LP1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    choiceHelper(crossoverMode,         Names::Crossover_Mode);
+    boolHelper  (crossoverSmoothing,    Names::Crossover_Smoothing);
+    
+    for( auto* freq : crossoverFreqs )
+    {
+        crossoverSettings.add({ freq });
+    }
     
-    AP2.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+    crossoverSettings.add({ crossoverMode, crossoverSmoothing });
+    gainSettings.add({ inputGainParam, outputGainParam });
     
-    LP2.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    HP2.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    // the rings hold about 5 s, so this has plenty of slack
+    startTimerHz(10);
 }
 
 SimpleMBCompAudioProcessor::~SimpleMBCompAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -159,35 +165,87 @@ void SimpleMBCompAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     
+    // processBlock never hands more than a sub-block to the DSP
     juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
+    spec.maximumBlockSize = subBlockSize;
     spec.numChannels = getTotalNumOutputChannels();
     spec.sampleRate = sampleRate;
     
     for( auto& comp : compressors )
+    {
         comp.prepare(spec);
+        comp.setChannelLayout(getChannelLayoutOfBus(false, 0));
+    }
+    
+    // a mono sidechain is split into its first channel only
+    auto sidechainSpec = spec;
+    sidechainSpec.numChannels = 2;
     
-    LP1.prepare(spec);
-    HP1.prepare(spec);
+    forEachPipeline([&](auto& pipeline)
+    {
+        pipeline.crossover.prepare(spec);
+        pipeline.sidechainCrossover.prepare(sidechainSpec);
+        
+        pipeline.inputGain.prepare(spec);
+        pipeline.outputGain.prepare(spec);
+        
+        pipeline.inputGain.setRampDurationSeconds(0.05);     // 50 ms
+        pipeline.outputGain.setRampDurationSeconds(0.05);    // 50 ms
+        
+        pipeline.bandArena.setSize     (static_cast<int>(spec.numChannels * Params::NumBands),        subBlockSize);
+        pipeline.sidechainArena.setSize(static_cast<int>(sidechainSpec.numChannels * Params::NumBands), subBlockSize);
+    });
     
-    AP2.prepare(spec);
+    automation = {};
     
-    LP2.prepare(spec);
-    HP2.prepare(spec);
+    for( size_t i = 0; i < crossoverFreqs.size(); ++i )
+    {
+        crossoverRamps[i].snap();
+        linearPhaseCrossover.setCrossoverFrequency         (i, crossoverFreqs[i]->get());
+        sidechainLinearPhaseCrossover.setCrossoverFrequency(i, crossoverFreqs[i]->get());
+    }
     
-    inputGain.prepare(spec);
-    outputGain.prepare(spec);
+    linearPhaseCrossover.prepare(spec);
+    sidechainLinearPhaseCrossover.prepare(sidechainSpec);
     
-    inputGain.setRampDurationSeconds(0.05);     // 50 ms
-    outputGain.setRampDurationSeconds(0.05);    // 50 ms
+    usingLinearPhase = crossoverMode->getIndex() == static_cast<int>(Params::CrossoverMode::LinearPhase);
+    linearPhaseCrossover.setEnabled         (usingLinearPhase);
+    sidechainLinearPhaseCrossover.setEnabled(usingLinearPhase);
     
-    for ( auto& buffer : filterBuffers )
+    // the lookahead is part of the latency, so bring the bands up to date now
+    // rather than waiting for the first block
+    for( auto& comp : compressors )
+        comp.updateCompressorSettings();
+    
+    lookaheadDelay = 0;
+    updateLookaheadDelay();
+    
+    setLatencySamples(getTotalLatency());
+    
+    deadlineMonitor.prepare(sampleRate);
+    
+#if SIMPLEMBCOMP_TRACE
+    trace.setSampleRate(sampleRate);
+#endif
+    
+    crossoverSettings.markDirty();
+    gainSettings.markDirty();
+    
+    samplesUntilSubBlock = 0;
+    
+    activeBands = getAudibleBands();
+    for( size_t i = 0; i < bandFades.size(); ++i )
     {
-        buffer.setSize(spec.numChannels, samplesPerBlock);
+        bandFades[i].reset(sampleRate, bandFadeSeconds);
+        bandFades[i].setCurrentAndTargetValue(activeBands[i] ? 1.f : 0.f);
     }
     
+    bandWarmups.fill(0);
+    
+#if ! SIMPLEMBCOMP_HEADLESS
     leftChannelFifo.prepare(samplesPerBlock);
     rightChannelFifo.prepare(samplesPerBlock);
+#endif
     
     osc.initialise([](float x){ return std::sin(x); });
     osc.prepare(spec);
@@ -203,6 +261,34 @@ void SimpleMBCompAudioProcessor::releaseResources()
     // spare memory, etc.
 }
 
+void SimpleMBCompAudioProcessor::reset()
+{
+    samplesUntilSubBlock = 0;
+    
+    forEachPipeline([](auto& pipeline)
+    {
+        pipeline.crossover.reset();
+        pipeline.sidechainCrossover.reset();
+        
+        pipeline.inputGain.reset();
+        pipeline.outputGain.reset();
+    });
+    
+    linearPhaseCrossover.reset();
+    sidechainLinearPhaseCrossover.reset();
+    
+    for( auto& comp : compressors )
+        comp.reset();
+}
+
+juce::AudioChannelSet SimpleMBCompAudioProcessor::getMainLayout(int numChannels)
+{
+    if( numChannels == 12 )
+        return juce::AudioChannelSet::create7point1point4();
+    
+    return juce::AudioChannelSet::canonicalChannelSet(numChannels);
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
@@ -210,18 +296,28 @@ bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     juce::ignoreUnused (layouts);
     return true;
 #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // mono, stereo and every surround layout up to 7.1.4; ambisonic channels
+    // aren't speakers, and compressing them apart would bend the sound field
+    auto mainLayout = layouts.getMainOutputChannelSet();
+    if( mainLayout.isDisabled()
+       || mainLayout.size() > maxMainChannels
+       || mainLayout.getAmbisonicOrder() >= 0 )
         return false;
     
     // This checks if the input layout matches the output layout
 #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    // the sidechain is optional, and can be mono or stereo
+    if( layouts.inputBuses.size() > 1 )
+    {
+        auto sidechain = layouts.getChannelSet(true, 1);
+        if( ! sidechain.isDisabled()
+           && sidechain != juce::AudioChannelSet::mono()
+           && sidechain != juce::AudioChannelSet::stereo() )
+            return false;
+    }
 #endif
     
     return true;
@@ -229,54 +325,424 @@ bool SimpleMBCompAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
 }
 #endif
 
-void SimpleMBCompAudioProcessor::updateState()
+void SimpleMBCompAudioProcessor::beginAutomation(int numSamples)
+{
+    automation.ramping = false;
+    for( auto& compressor : compressors )
+        automation.ramping = compressor.beginAutomation() || automation.ramping;
+    
+    // like the compressors', crossover ramps stay followed until the
+    // frequencies have been set to where they end
+    auto crossoversMoving = false;
+    for( auto& ramp : crossoverRamps )
+        crossoversMoving = ramp.begin() || crossoversMoving;
+    
+    automation.crossoversRamping = crossoversMoving || automation.crossoversRamping;
+    
+    automation.ramping = automation.ramping || automation.crossoversRamping;
+    
+    // how many sub-blocks start within this host block
+    auto firstStart = samplesUntilSubBlock;
+    auto numStarts = firstStart < numSamples ? (numSamples - firstStart - 1) / subBlockSize + 1 : 0;
+    
+    automation.numSamples = juce::jmax(1, numSamples);
+    automation.stride = juce::jmax(1, (numStarts + maxAutomationSplits - 1) / maxAutomationSplits);
+    automation.numSubBlockStarts = 0;
+}
+
+void SimpleMBCompAudioProcessor::updateState(int hostPosition)
 {
+    /*
+     The settings computed here hold until the next sub-block start that
+     follows the ramps, so they're taken from where that span ends. The last
+     span of a host block ends with it, which lands every ramp on its target.
+     */
+    auto index = automation.numSubBlockStarts++;
+    auto nextFollowed = (index / automation.stride + 1) * automation.stride;
+    auto spanEnd = hostPosition + (nextFollowed - index) * subBlockSize;
+    
+    auto proportion = juce::jmin(1.f, static_cast<float>(spanEnd) / static_cast<float>(automation.numSamples));
+    auto followRamps = automation.ramping && index % automation.stride == 0;
+    
     for( auto& compressor : compressors )
-        compressor.updateCompressorSettings();
+        compressor.updateCompressorSettings(proportion, followRamps);
+    
+    updateLookaheadDelay();
+    
+    auto crossoversUpdated = true;
+    if( crossoverSettings.consumeChange() )
+        updateCrossovers(proportion);
+    else if( followRamps && automation.crossoversRamping )
+        updateCrossoverFrequencies(proportion);
+    else
+        crossoversUpdated = false;
+    
+    if( crossoversUpdated && proportion >= 1.f )
+        automation.crossoversRamping = false;
+    
+    if( gainSettings.consumeChange() )
+    {
+        forEachPipeline([this](auto& pipeline)
+        {
+            pipeline.inputGain.setGainDecibels (inputGainParam->get());
+            pipeline.outputGain.setGainDecibels(outputGainParam->get());
+        });
+    }
+}
+
+void SimpleMBCompAudioProcessor::updateCrossovers(float proportion)
+{
+    forEachPipeline([this](auto& pipeline)
+    {
+        pipeline.crossover.setCutoffSmoothingEnabled         (crossoverSmoothing->get());
+        pipeline.sidechainCrossover.setCutoffSmoothingEnabled(crossoverSmoothing->get());
+    });
+    
+    updateCrossoverFrequencies(proportion);
+    
+    auto linearPhase = crossoverMode->getIndex() == static_cast<int>(Params::CrossoverMode::LinearPhase);
+    if( linearPhase != usingLinearPhase.load() )
+    {
+        // start the newly selected crossover from silence, and let the host
+        // know about the latency change from the message thread
+        if( linearPhase )
+        {
+            linearPhaseCrossover.reset();
+            sidechainLinearPhaseCrossover.reset();
+        }
+        else
+        {
+            forEachPipeline([](auto& pipeline)
+            {
+                pipeline.crossover.reset();
+                pipeline.sidechainCrossover.reset();
+            });
+        }
+        
+        linearPhaseCrossover.setEnabled         (linearPhase);
+        sidechainLinearPhaseCrossover.setEnabled(linearPhase);
+        
+        usingLinearPhase = linearPhase;
+        latencyChanged = true;
+    }
+}
+
+/*
+ The IIR crossovers follow the ramps. Every change of a linear phase
+ crossover means new kernels from its background thread, so those go
+ straight to where the ramps end.
+ */
+void SimpleMBCompAudioProcessor::updateCrossoverFrequencies(float proportion)
+{
+    for( size_t i = 0; i < crossoverRamps.size(); ++i )
+    {
+        auto frequency = crossoverRamps[i].getValue(proportion);
+        auto target =    crossoverRamps[i].getTarget();
+        
+        forEachPipeline([i, frequency](auto& pipeline)
+        {
+            pipeline.crossover.setCrossoverFrequency         (i, frequency);
+            pipeline.sidechainCrossover.setCrossoverFrequency(i, frequency);
+        });
+        
+        linearPhaseCrossover.setCrossoverFrequency         (i, target);
+        sidechainLinearPhaseCrossover.setCrossoverFrequency(i, target);
+    }
+}
+
+juce::uint64 SimpleMBCompAudioProcessor::getNumSkippedUpdates() const
+{
+    auto skipped = crossoverSettings.getNumSkippedUpdates() + gainSettings.getNumSkippedUpdates();
+    
+    for( const auto& comp : compressors )
+        skipped += comp.getNumSkippedUpdates();
+    
+    return skipped;
+}
+
+template<typename SampleType>
+typename SimpleMBCompAudioProcessor::Pipeline<SampleType>::BandBlocks
+SimpleMBCompAudioProcessor::getBandBlocks(juce::AudioBuffer<SampleType>& arena,
+                                          size_t numChannels,
+                                          size_t numSamples)
+{
+    auto arenaBlock = juce::dsp::AudioBlock<SampleType>(arena);
+    auto channelsPerBand = arenaBlock.getNumChannels() / Params::NumBands;
+    jassert(numChannels <= channelsPerBand && numSamples <= arenaBlock.getNumSamples());
+    
+    typename Pipeline<SampleType>::BandBlocks bandBlocks;
+    for( size_t i = 0; i < bandBlocks.size(); ++i )
+    {
+        bandBlocks[i] = arenaBlock.getSubsetChannelBlock(i * channelsPerBand, numChannels)
+                                  .getSubBlock(0, numSamples);
+    }
+    
+    return bandBlocks;
+}
+
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::splitBands(const juce::AudioBuffer<SampleType> &inputBuffer)
+{
+    auto& pipeline = getPipeline<SampleType>();
+    
+    auto input = juce::dsp::AudioBlock<const SampleType>(inputBuffer);
+    pipeline.bands = getBandBlocks(pipeline.bandArena, input.getNumChannels(), input.getNumSamples());
     
-    auto lowMidCutoffFreq = lowMidCrossover->get();
-    LP1.setCutoffFrequency(lowMidCutoffFreq);
-    HP1.setCutoffFrequency(lowMidCutoffFreq);
+    splitBands(input, pipeline.bands, pipeline.crossover, linearPhaseCrossover);
+}
+
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::splitSidechain(const juce::AudioBuffer<SampleType> &sidechainBuffer)
+{
+    auto& pipeline = getPipeline<SampleType>();
     
-    auto midHighCutoffFreq = midHighCrossover->get();
-    AP2.setCutoffFrequency(midHighCutoffFreq);
-    LP2.setCutoffFrequency(midHighCutoffFreq);
-    HP2.setCutoffFrequency(midHighCutoffFreq);
+    // the sidechain arena only has room for a stereo pair per band
+    auto numChannels = juce::jmin(static_cast<size_t>(sidechainBuffer.getNumChannels()),
+                                  static_cast<size_t>(pipeline.sidechainArena.getNumChannels()) / Params::NumBands);
+    auto input = juce::dsp::AudioBlock<const SampleType>(sidechainBuffer)
+                    .getSubsetChannelBlock(0, numChannels);
     
-    inputGain.setGainDecibels (inputGainParam->get());
-    outputGain.setGainDecibels(outputGainParam->get());
+    pipeline.sidechainBands = getBandBlocks(pipeline.sidechainArena, numChannels, input.getNumSamples());
+    
+    splitBands(input, pipeline.sidechainBands, pipeline.sidechainCrossover, sidechainLinearPhaseCrossover);
+}
+
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::splitBands(const juce::dsp::AudioBlock<const SampleType>& input,
+                                            typename Pipeline<SampleType>::BandBlocks& bandBlocks,
+                                            typename Pipeline<SampleType>::Crossover& iirCrossover,
+                                            LinearPhaseCrossover<Params::NumBands>& linearCrossover)
+{
+    /*
+     Every band of the linear phase crossover is its own FIR, so the ones that
+     can't be heard are skipped. The IIR legs can't be: the allpass compensation
+     of the lower bands runs through the upper splits, and all legs of a split
+     share the same SIMD registers, so leaving one out saves nothing and would
+     leave its filter state behind.
+     */
+    if( usingLinearPhase )
+        linearCrossover.process(input, bandBlocks, activeBands);
+    else
+        iirCrossover.process(input, bandBlocks);
 }
 
-void SimpleMBCompAudioProcessor::splitBands(const juce::AudioBuffer<float> &inputBuffer)
+SimpleMBCompAudioProcessor::BandMask SimpleMBCompAudioProcessor::getAudibleBands() const
 {
-    for( auto& fb : filterBuffers )
+    auto bandsAreSoloed = false;
+    for( auto& comp : compressors )
     {
-        fb = inputBuffer;
+        if( comp.solo->get() )
+        {
+            bandsAreSoloed = true;
+            break;
+        }
     }
     
-    auto fb0Block = juce::dsp::AudioBlock<float>(filterBuffers[0]);
-    auto fb1Block = juce::dsp::AudioBlock<float>(filterBuffers[1]);
-    auto fb2Block = juce::dsp::AudioBlock<float>(filterBuffers[2]);
+    BandMask audible;
+    for( size_t i = 0; i < compressors.size(); ++i )
+    {
+        auto& comp = compressors[i];
+        audible[i] = bandsAreSoloed ? comp.solo->get() : ! comp.mute->get();
+    }
     
-    auto fb0Ctx =   juce::dsp::ProcessContextReplacing<float>(fb0Block);
-    auto fb1Ctx =   juce::dsp::ProcessContextReplacing<float>(fb1Block);
-    auto fb2Ctx =   juce::dsp::ProcessContextReplacing<float>(fb2Block);
+    return audible;
+}
+
+void SimpleMBCompAudioProcessor::updateActiveBands()
+{
+    auto audible = getAudibleBands();
     
-    LP1.process(fb0Ctx);
-    AP2.process(fb0Ctx);
+    BandMask active;
+    for( size_t i = 0; i < bandFades.size(); ++i )
+    {
+        // called once per sub-block, so an active band has run subBlockSize more samples
+        auto& warmup = bandWarmups[i];
+        if( activeBands[i] )
+            warmup = juce::jmax(0, warmup - subBlockSize);
+        
+        if( ! audible[i] )
+            warmup = 0;
+        else if( ! activeBands[i] && usingLinearPhase )
+            warmup = linearPhaseCrossover.getFillSamples();
+        
+        auto& fade = bandFades[i];
+        fade.setTargetValue(audible[i] && warmup == 0 ? 1.f : 0.f);
+        active[i] = audible[i] || fade.isSmoothing();
+        
+        // whatever the band was holding is stale by the time it's heard again
+        if( activeBands[i] && ! active[i] )
+            compressors[i].reset();
+    }
     
-    HP1.process(fb1Ctx);
-    filterBuffers[2] = filterBuffers[1];
-    LP2.process(fb1Ctx);
+    // nothing at all is split while every band is silent
+    if( activeBands.any() && active.none() )
+    {
+        forEachPipeline([](auto& pipeline)
+        {
+            pipeline.crossover.reset();
+            pipeline.sidechainCrossover.reset();
+        });
+        
+        linearPhaseCrossover.reset();
+        sidechainLinearPhaseCrossover.reset();
+    }
     
-    HP2.process(fb2Ctx);
+    activeBands = active;
 }
 
-void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::sumBands(juce::AudioBuffer<SampleType>& buffer)
+{
+    const auto& bands = getPipeline<SampleType>().bands;
+    
+    auto numSamples =  buffer.getNumSamples();
+    auto numChannels = buffer.getNumChannels();
+    
+    buffer.clear();
+    
+    for( size_t i = 0; i < bands.size(); ++i )
+    {
+        auto& fade = bandFades[i];
+        
+        if( fade.isSmoothing() )
+        {
+            auto startGain = fade.getCurrentValue();
+            auto endGain =   fade.skip(numSamples);
+            
+            for( auto ch = 0; ch < numChannels; ++ch )
+            {
+                buffer.addFromWithRamp(ch, 0, bands[i].getChannelPointer(static_cast<size_t>(ch)), numSamples,
+                                       static_cast<SampleType>(startGain), static_cast<SampleType>(endGain));
+            }
+        }
+        else if( fade.getTargetValue() > 0.f )
+        {
+            for( auto ch = 0; ch < numChannels; ++ch )
+            {
+                buffer.addFrom(ch, 0, bands[i].getChannelPointer(static_cast<size_t>(ch)), numSamples);
+            }
+        }
+    }
+}
+
+void SimpleMBCompAudioProcessor::updateMeterHistory()
+{
+    for( size_t i = 0; i < compressors.size(); ++i )
+    {
+        MeterReading frame;
+        while( compressors[i].pullHistoryFrame(frame) )
+        {
+            meterHistory[i].addFrame(frame);
+        }
+    }
+}
+
+void SimpleMBCompAudioProcessor::clearMeterHistory()
+{
+    updateMeterHistory();
+    
+    for( auto& history : meterHistory )
+        history.clear();
+}
+
+void SimpleMBCompAudioProcessor::updateLookaheadDelay()
+{
+    auto delay = 0;
+    for( const auto& comp : compressors )
+        delay = juce::jmax(delay, comp.getLookaheadSamples());
+    
+    for( auto& comp : compressors )
+        comp.setAlignmentDelay(delay);
+    
+    if( delay != lookaheadDelay.load() )
+    {
+        lookaheadDelay = delay;
+        latencyChanged = true;
+    }
+}
+
+int SimpleMBCompAudioProcessor::getTotalLatency() const
+{
+    auto crossoverLatency = usingLinearPhase ? linearPhaseCrossover.getLatencyInSamples() : 0;
+    return crossoverLatency + lookaheadDelay.load();
+}
+
+/*
+ Posting a message allocates and takes the message queue's lock, so the audio
+ thread leaves a flag for the timer rather than triggering an async update.
+ */
+void SimpleMBCompAudioProcessor::timerCallback()
+{
+    if( latencyChanged.exchange(false) )
+        setLatencySamples(getTotalLatency());
+    
+    updateMeterHistory();
+}
+
+bool SimpleMBCompAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& hostBuffer, juce::MidiBuffer& midiMessages)
+{
+    process(hostBuffer);
+}
+
+void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<double>& hostBuffer, juce::MidiBuffer& midiMessages)
+{
+    process(hostBuffer);
+}
+
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::process(juce::AudioBuffer<SampleType>& hostBuffer)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    RealtimeGuard::Scope realtime;
+    DeadlineMonitor::ScopedBlock deadline(deadlineMonitor, hostBuffer.getNumSamples(), ! isNonRealtime());
+#if SIMPLEMBCOMP_TRACE
+    StageProfiler::Laps laps(profiler, &trace.getAudioThreadEvents(), hostBuffer.getNumSamples());
+#else
+    StageProfiler::Laps laps(profiler);
+#endif
+    
+    auto numSamples = hostBuffer.getNumSamples();
+    beginAutomation(numSamples);
+    
+    for( int start = 0; start < numSamples; )
+    {
+        auto startsSubBlock = samplesUntilSubBlock == 0;
+        if( startsSubBlock )
+            samplesUntilSubBlock = subBlockSize;
+        
+        auto num = juce::jmin(samplesUntilSubBlock, numSamples - start);
+        
+        // refers to the host's channels, so nothing is copied or allocated
+        juce::AudioBuffer<SampleType> subBlock(hostBuffer.getArrayOfWritePointers(),
+                                               hostBuffer.getNumChannels(),
+                                               start,
+                                               num);
+        processSubBlock(subBlock, start, startsSubBlock, laps);
+        
+        samplesUntilSubBlock -= num;
+        start += num;
+    }
+}
+
+template<typename SampleType>
+void SimpleMBCompAudioProcessor::processSubBlock(juce::AudioBuffer<SampleType>& hostBuffer,
+                                                 int hostPosition,
+                                                 bool startsSubBlock,
+                                                 StageProfiler::Laps& laps)
+{
+    auto& pipeline = getPipeline<SampleType>();
+    
+    // the host buffer also carries the sidechain channels when that bus is
+    // enabled, so everything below works on the main bus only
+    auto buffer = getBusBuffer(hostBuffer, false, 0);
+    
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
     
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -287,9 +753,13 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    updateState();
+    if( startsSubBlock )
+        updateState(hostPosition);
+    
+    laps.end(StageProfiler::Parameters);
     
-    if( false )
+    // the test tone's oscillator is float only
+    if constexpr( std::is_same_v<SampleType, float> && false )
     {
         buffer.clear();
         auto block = juce::dsp::AudioBlock<float>(buffer);
@@ -300,77 +770,82 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
         gain.process(ctx);
     }
     
+#if ! SIMPLEMBCOMP_HEADLESS
     leftChannelFifo.update(buffer);
     rightChannelFifo.update(buffer);
+#endif
     
-    applyGain(buffer, inputGain);
+    applyGain(buffer, pipeline.inputGain);
     
-    splitBands(buffer);
+    if( startsSubBlock )
+        updateActiveBands();
+    
+    laps.end(StageProfiler::Input);
     
-    for( size_t i = 0; i < filterBuffers.size(); ++i )
+    // every band is muted, so there's nothing to split or compress
+    if( activeBands.none() )
     {
-        compressors[i].process(filterBuffers[i]);
+        for( auto& comp : compressors )
+            comp.skip(buffer.getNumSamples());
+        
+        buffer.clear();
+        applyGain(buffer, pipeline.outputGain);
+        laps.end(StageProfiler::Output);
+        return;
     }
     
-    auto numSamples =  buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
+    splitBands(buffer);
     
-    buffer.clear();
+    // with no sidechain connected the detectors key from their own band, and
+    // the sidechain is never split
+    auto sidechain = getBusCount(true) > 1 ? getBusBuffer(hostBuffer, true, 1) : juce::AudioBuffer<SampleType>();
+    auto useSidechain = sidechain.getNumChannels() > 0;
     
-    auto addFilterBand = [nc = numChannels, ns = numSamples](auto& inputBuffer, const auto& source)
-    {
-        for ( auto i = 0; i < nc; ++i )
-        {
-            inputBuffer.addFrom(i, 0, source, i, 0, ns);
-        }
-    };
+    if( useSidechain )
+        splitSidechain(sidechain);
     
-    auto bandsAreSoloed = false;
-    for( auto& comp : compressors )
-    {
-        if( comp.solo->get() )
-        {
-            bandsAreSoloed = true;
-            break;
-        }
-    }
+    laps.end(StageProfiler::Split);
     
-    if( bandsAreSoloed )
+    for( size_t i = 0; i < pipeline.bands.size(); ++i )
     {
-        for( size_t i = 0; i < compressors.size(); ++i )
+        if( activeBands[i] )
         {
-            auto& comp = compressors[i];
-            if( comp.solo->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
+            auto sidechainBand = useSidechain ? juce::dsp::AudioBlock<const SampleType>(pipeline.sidechainBands[i])
+                                              : juce::dsp::AudioBlock<const SampleType>();
+            compressors[i].process(pipeline.bands[i], sidechainBand);
         }
-    }
-    else
-    {
-        for( size_t i = 0; i < compressors.size(); ++i )
+        else
         {
-            auto& comp = compressors[i];
-            if( ! comp.mute->get() )
-            {
-                addFilterBand(buffer, filterBuffers[i]);
-            }
+            compressors[i].skip(buffer.getNumSamples());
         }
+        
+        laps.end(StageProfiler::getCompressStage(i));
     }
     
-    applyGain(buffer, outputGain);
+    sumBands(buffer);
+    laps.end(StageProfiler::Sum);
+    
+    applyGain(buffer, pipeline.outputGain);
+    laps.end(StageProfiler::Output);
 }
 
 //==============================================================================
 bool SimpleMBCompAudioProcessor::hasEditor() const
 {
-    return true; // (change this to false if you choose to not supply an editor)
+    return ! SIMPLEMBCOMP_HEADLESS;
 }
 
 juce::AudioProcessorEditor* SimpleMBCompAudioProcessor::createEditor()
 {
-    //    return new juce::GenericAudioProcessorEditor(*this);
-    return new SimpleMBCompAudioProcessorEditor (*this);
+#if SIMPLEMBCOMP_HEADLESS
+    return nullptr;
+#else
+    // the custom editor is laid out for three bands
+    if constexpr( Params::NumBands != 3 )
+        return new juce::GenericAudioProcessorEditor(*this);
+    else
+        return new SimpleMBCompAudioProcessorEditor (*this);
+#endif
 }
 
 //==============================================================================
@@ -417,130 +892,117 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
                                                      0));
     
     auto thresholdRange = NormalisableRange<float>(MIN_THRESHOLD, MAX_DECIBELS, 1, 1);
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Threshold_Low_Band), 1},
-                                                     params.at(Names::Threshold_Low_Band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Threshold_Mid_Band), 1},
-                                                     params.at(Names::Threshold_Mid_Band),
-                                                     thresholdRange,
-                                                     0));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Threshold_High_Band), 1},
-                                                     params.at(Names::Threshold_High_Band),
-                                                     thresholdRange,
-                                                     0));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forBand(Names::Threshold_Band, band)), 1},
+                                                         params.at(forBand(Names::Threshold_Band, band)),
+                                                         thresholdRange,
+                                                         0));
+    }
     
     auto attackReleaseRange = NormalisableRange<float>(5, 500, 1, 1);
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Attack_Low_Band), 1},
-                                                     params.at(Names::Attack_Low_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Attack_Mid_Band), 1},
-                                                     params.at(Names::Attack_Mid_Band),
-                                                     attackReleaseRange,
-                                                     50));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Attack_High_Band), 1},
-                                                     params.at(Names::Attack_High_Band),
-                                                     attackReleaseRange,
-                                                     50));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forBand(Names::Attack_Band, band)), 1},
+                                                         params.at(forBand(Names::Attack_Band, band)),
+                                                         attackReleaseRange,
+                                                         50));
+    }
     
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Release_Low_Band), 1},
-                                                     params.at(Names::Release_Low_Band),
-                                                     attackReleaseRange,
-                                                     250));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Release_Mid_Band), 1},
-                                                     params.at(Names::Release_Mid_Band),
-                                                     attackReleaseRange,
-                                                     250));
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Release_High_Band), 1},
-                                                     params.at(Names::Release_High_Band),
-                                                     attackReleaseRange,
-                                                     250));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forBand(Names::Release_Band, band)), 1},
+                                                         params.at(forBand(Names::Release_Band, band)),
+                                                         attackReleaseRange,
+                                                         250));
+    }
     
-    auto choices = std::vector<double>{ 1, 1.5, 2, 3, 4, 5, 6, 7, 8, 10, 15, 20, 50, 100 };
     juce::StringArray sa;
-    for( auto choice : choices )
+    for( auto choice : RatioChoices )
     {
         sa.add( juce::String(choice, 1) );
     }
     
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
-                                                      params.at(Names::Ratio_Low_Band), 1},
-                                                      params.at(Names::Ratio_Low_Band),
-                                                      sa,
-                                                      3));
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
-                                                      params.at(Names::Ratio_Mid_Band), 1},
-                                                      params.at(Names::Ratio_Mid_Band),
-                                                      sa,
-                                                      3));
-    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
-                                                      params.at(Names::Ratio_High_Band), 1},
-                                                      params.at(Names::Ratio_High_Band),
-                                                      sa,
-                                                      3));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
+                                                          params.at(forBand(Names::Ratio_Band, band)), 1},
+                                                          params.at(forBand(Names::Ratio_Band, band)),
+                                                          sa,
+                                                          3));
+    }
     
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Bypassed_Low_Band), 1},
-                                                    params.at(Names::Bypassed_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Bypassed_Mid_Band), 1},
-                                                    params.at(Names::Bypassed_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Bypassed_High_Band), 1},
-                                                    params.at(Names::Bypassed_High_Band),
-                                                    false));
+    auto kneeRange = NormalisableRange<float>(0, 24, 0.5f, 1);
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forBand(Names::Knee_Band, band)), 1},
+                                                         params.at(forBand(Names::Knee_Band, band)),
+                                                         kneeRange,
+                                                         0));
+    }
     
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Mute_Low_Band), 1},
-                                                    params.at(Names::Mute_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Mute_Mid_Band), 1},
-                                                    params.at(Names::Mute_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Mute_High_Band), 1},
-                                                    params.at(Names::Mute_High_Band),
-                                                    false));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
+                                                          params.at(forBand(Names::Engine_Band, band)), 1},
+                                                          params.at(forBand(Names::Engine_Band, band)),
+                                                          getCompressorEngineChoices(),
+                                                          static_cast<int>(CompressorEngine::Fast)));
+    }
     
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Solo_Low_Band), 1},
-                                                    params.at(Names::Solo_Low_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Solo_Mid_Band), 1},
-                                                    params.at(Names::Solo_Mid_Band),
-                                                    false));
-    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
-                                                    params.at(Names::Solo_High_Band), 1},
-                                                    params.at(Names::Solo_High_Band),
-                                                    false));
+    auto lookaheadRange = NormalisableRange<float>(0, MAX_LOOKAHEAD_MS, 0.1f, 1);
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forBand(Names::Lookahead_Band, band)), 1},
+                                                         params.at(forBand(Names::Lookahead_Band, band)),
+                                                         lookaheadRange,
+                                                         0));
+    }
     
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Low_Mid_Crossover_Freq), 1},
-                                                     params.at(Names::Low_Mid_Crossover_Freq),
-                                                     NormalisableRange<float>(MIN_FREQUENCY, 999,
-                                                                              1, 1),
-                                                     400));
+    for( size_t band = 0; band < NumBands; ++band )
+    {
+        layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
+                                                          params.at(forBand(Names::Detector_Band, band)), 1},
+                                                          params.at(forBand(Names::Detector_Band, band)),
+                                                          getDetectorModeChoices(),
+                                                          0));
+    }
     
-    layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
-                                                     params.at(Names::Mid_High_Crossover_Freq), 1},
-                                                     params.at(Names::Mid_High_Crossover_Freq),
-                                                     NormalisableRange<float>(1000, MAX_FREQUENCY,
-                                                                              1, 1),
-                                                     2000));
+    for( auto first : { Names::Bypassed_Band, Names::Mute_Band, Names::Solo_Band } )
+    {
+        for( size_t band = 0; band < NumBands; ++band )
+        {
+            layout.add(std::make_unique<AudioParameterBool>(ParameterID {
+                                                            params.at(forBand(first, band)), 1},
+                                                            params.at(forBand(first, band)),
+                                                            false));
+        }
+    }
+    
+    for( size_t i = 0; i < NumCrossovers; ++i )
+    {
+        layout.add(std::make_unique<AudioParameterFloat>(ParameterID {
+                                                         params.at(forCrossover(i)), 1},
+                                                         params.at(forCrossover(i)),
+                                                         getCrossoverRange(i),
+                                                         getCrossoverDefault(i)));
+    }
+    
+    layout.add(std::make_unique<AudioParameterChoice>(ParameterID {
+                                                      params.at(Names::Crossover_Mode), 1},
+                                                      params.at(Names::Crossover_Mode),
+                                                      getCrossoverModeChoices(),
+                                                      static_cast<int>(CrossoverMode::MinimumPhase)));
+    
+    layout.add(std::make_unique<AudioParameterBool>(ParameterID {
+                                                    params.at(Names::Crossover_Smoothing), 1},
+                                                    params.at(Names::Crossover_Smoothing),
+                                                    true));
     
     return layout;
 }
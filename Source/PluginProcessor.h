@@ -39,13 +39,33 @@
  */
 
 #include <JuceHeader.h>
+#include <bitset>
+#include <type_traits>
 #include "DSP/CompressorBand.h"
+#include "DSP/DeadlineMonitor.h"
+#include "DSP/LinkwitzRileyCrossover.h"
+#include "DSP/LinearPhaseCrossover.h"
+#include "DSP/MeterPyramid.h"
+#include "DSP/ParameterGroup.h"
+#include "DSP/Params.h"
+#include "DSP/RampedParameter.h"
+#include "DSP/RealtimeGuard.h"
 #include "DSP/SingleChannelSampleFifo.h"
+#include "DSP/StageTrace.h"
+
+/*
+ Builds that only need the DSP, like the offline renderer, define this to 1 to
+ leave the editor out.
+ */
+#ifndef SIMPLEMBCOMP_HEADLESS
+#define SIMPLEMBCOMP_HEADLESS 0
+#endif
 
 /**
  */
 //==============================================================================
-class SimpleMBCompAudioProcessor : public juce::AudioProcessor
+class SimpleMBCompAudioProcessor : public juce::AudioProcessor,
+private juce::Timer
 #if JucePlugin_Enable_ARA
 ,
 public juce::AudioProcessorARAExtension
@@ -59,12 +79,26 @@ public:
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock)        override;
     void releaseResources()                                           override;
+    void reset()                                                      override;
     
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout &layouts) const     override;
 #endif
     
-    void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
+    void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &)  override;
+    void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+    
+    bool supportsDoublePrecisionProcessing() const                    override;
+    
+    // 7.1.4, the largest main bus layout the processor accepts
+    static constexpr int maxMainChannels = 12;
+    
+    /*
+     The layout for a bus of numChannels when nothing says which one it is,
+     like a file or a benchmark: JUCE's canonical one, apart from 12 channels,
+     which are taken to be 7.1.4 rather than discrete.
+     */
+    static juce::AudioChannelSet getMainLayout(int numChannels);
     
     //==============================================================================
     juce::AudioProcessorEditor *createEditor() override;
@@ -95,41 +129,209 @@ public:
     APVTS apvts{*this, nullptr, "Parameters", createParameterLayout()};
     
     using BlockType = juce::AudioBuffer<float>;
+#if ! SIMPLEMBCOMP_HEADLESS
+    // only the editor's analyzer reads these
     SingleChannelSampleFifo<BlockType> leftChannelFifo  { Channel::Left };
     SingleChannelSampleFifo<BlockType> rightChannelFifo { Channel::Right };
+#endif
+    
+    std::array<CompressorBand, Params::NumBands> compressors;
+    
+    // number of per block coefficient updates that were skipped because
+    // nothing in their parameter group changed
+    juce::uint64 getNumSkippedUpdates() const;
+    
+    /*
+     Session long meter history of every band. The bands' history rings are
+     drained into it on a timer; anything that drives the processor without a
+     message loop calls updateMeterHistory() itself. Both, and all queries,
+     belong on the same thread.
+     */
+    void updateMeterHistory();
+    void clearMeterHistory();
+    const MeterPyramid& getMeterHistory(size_t band) const { return meterHistory[band]; }
     
-    std::array<CompressorBand, 3>   compressors;
-    CompressorBand& lowBandComp =   compressors[0];
-    CompressorBand& midBandComp =   compressors[1];
-    CompressorBand& highBandComp =  compressors[2];
+    // times every stage of processBlock, set it while the processor isn't running
+    void setStageProfiler(StageProfiler* profilerToUse) { profiler = profilerToUse; }
     
+#if SIMPLEMBCOMP_TRACE
+    StageTrace& getTrace() { return trace; }
+#endif
+    
+    // how long processBlock takes against its real time budget, offline renders left out
+    DeadlineMonitor& getDeadlineMonitor() { return deadlineMonitor; }
+
 private:
-    using Filter = juce::dsp::LinkwitzRileyFilter<float>;
-    //      fc0     fc1
-    Filter  LP1,    AP2,
-            HP1,    LP2,
-                    HP2;
+    /*
+     Everything on the signal path that holds samples comes in float and
+     double, so a 64-bit host bus is processed as it is rather than converted
+     on the way in and out. Both are prepared and follow the parameters, and
+     processBlock runs the one that matches the host's buffer.
+     */
+    template<typename SampleType>
+    struct Pipeline
+    {
+        using Crossover =  LinkwitzRileyCrossover<Params::NumBands, SampleType>;
+        using BandBlocks = typename Crossover::BandBlocks;
+        
+        Crossover crossover;
+        
+        // the sidechain is split the same way as the main input, so every band's
+        // detector hears the sidechain with the same phase and latency
+        Crossover sidechainCrossover;
+        
+        /*
+         The bands of a sub-block are views into one preallocated arena that holds
+         every band's channels, one band after the other, so the crossovers write
+         straight into it and the compressors work on it in place.
+         */
+        juce::AudioBuffer<SampleType> bandArena, sidechainArena;
+        BandBlocks bands, sidechainBands;
+        
+        juce::dsp::Gain<SampleType> inputGain, outputGain;
+    };
+    
+    Pipeline<float>  floatPipeline;
+    Pipeline<double> doublePipeline;
+    
+    template<typename SampleType>
+    Pipeline<SampleType>& getPipeline()
+    {
+        if constexpr( std::is_same_v<SampleType, double> )
+            return doublePipeline;
+        else
+            return floatPipeline;
+    }
+    
+    template<typename Function>
+    void forEachPipeline(Function&& function)
+    {
+        function(floatPipeline);
+        function(doublePipeline);
+    }
     
-    juce::AudioParameterFloat* lowMidCrossover  { nullptr };
-    juce::AudioParameterFloat* midHighCrossover { nullptr };
+    // juce::dsp::Convolution is float only, double blocks are converted inside
+    LinearPhaseCrossover<Params::NumBands> linearPhaseCrossover;
+    LinearPhaseCrossover<Params::NumBands> sidechainLinearPhaseCrossover;
     
-    std::array<juce::AudioBuffer<float>, 3> filterBuffers;
+    std::array<juce::AudioParameterFloat*, Params::NumCrossovers> crossoverFreqs {};
+    juce::AudioParameterChoice* crossoverMode      { nullptr };
+    juce::AudioParameterBool*   crossoverSmoothing { nullptr };
+    
+    std::atomic<bool> usingLinearPhase { false };
+    std::atomic<int>  lookaheadDelay { 0 };
+    
+    // raised by the audio thread, the latency is reported from the timer
+    std::atomic<bool> latencyChanged { false };
+    
+    ParameterGroup crossoverSettings, gainSettings;
+    
+    int getTotalLatency() const;
+    
+    std::array<MeterPyramid, Params::NumBands> meterHistory;
+    StageProfiler* profiler { nullptr };
+    DeadlineMonitor deadlineMonitor;
+#if SIMPLEMBCOMP_TRACE
+    StageTrace trace;
+#endif
+    void timerCallback() override;
+    
+    /*
+     Everything from reading the parameters to the output gain runs on
+     sub-blocks of subBlockSize samples, whatever block size the host picked.
+     The sub-block grid carries over from one processBlock call to the next; a
+     host block that ends partway through a sub-block splits it in two without
+     starting a new one. Parameters are read, and bands faded in and out, at the
+     same sample positions for any host block size, and the band buffers only
+     ever have to hold one sub-block.
+     */
+    static constexpr int subBlockSize = 64;
+    int samplesUntilSubBlock { 0 };
+    
+    template<typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& hostBuffer);
+    
+    template<typename SampleType>
+    void processSubBlock(juce::AudioBuffer<SampleType>& hostBuffer, int hostPosition, bool startsSubBlock, StageProfiler::Laps& laps);
+    
+    /*
+     Automation is followed within a host block by ramping the compressors'
+     settings and the crossover frequencies across it, see RampedParameter.
+     While anything ramps, the settings are recomputed at sub-block starts,
+     but no more than maxAutomationSplits times per host block, which bounds
+     what a long block full of automation can cost. A ramp stays followed,
+     into later host blocks if need be, until the settings reach its target.
+     */
+    static constexpr int maxAutomationSplits = 16;
+    
+    struct Automation
+    {
+        int numSamples { 1 };       // in the current host block
+        int stride { 1 };           // sub-block starts per recompute
+        int numSubBlockStarts { 0 };
+        bool ramping { false };
+        bool crossoversRamping { false };
+    };
+    
+    Automation automation;
+    std::array<RampedParameter, Params::NumCrossovers> crossoverRamps;
+    
+    void beginAutomation(int numSamples);
+    
+    template<typename SampleType>
+    static typename Pipeline<SampleType>::BandBlocks getBandBlocks(juce::AudioBuffer<SampleType>& arena,
+                                                                   size_t numChannels,
+                                                                   size_t numSamples);
+    
+    /*
+     Bands that are muted, or left out by another band's solo, are neither
+     compressed nor summed. A band is faded in and out over bandFadeSeconds
+     when that changes, and only counts as inactive once it has faded out.
+     
+     A linear phase band that comes back starts from a cleared FIR, so it runs
+     silently for bandWarmups[i] more samples until the FIR is full again, and
+     only then fades in.
+     */
+    using BandMask = std::bitset<Params::NumBands>;
+    
+    static constexpr double bandFadeSeconds = 0.01;
+    std::array<juce::SmoothedValue<float>, Params::NumBands> bandFades;
+    std::array<int, Params::NumBands> bandWarmups {};
+    BandMask activeBands;
+    
+    BandMask getAudibleBands() const;
+    void updateActiveBands();
     
-    juce::dsp::Gain<float> inputGain, outputGain;
     juce::AudioParameterFloat* inputGainParam   { nullptr };
     juce::AudioParameterFloat* outputGainParam  { nullptr };
     
-    template<typename T, typename U>
-    void applyGain(T& buffer, U& gain)
+    template<typename SampleType>
+    void applyGain(juce::AudioBuffer<SampleType>& buffer, juce::dsp::Gain<SampleType>& gain)
     {
-        auto block = juce::dsp::AudioBlock<float>           (buffer);
-        auto ctx = juce::dsp::ProcessContextReplacing<float>(block);
+        auto block = juce::dsp::AudioBlock<SampleType>           (buffer);
+        auto ctx = juce::dsp::ProcessContextReplacing<SampleType>(block);
         gain.process(ctx);
     }
     
-    void updateState();
+    void updateState(int hostPosition);
+    void updateCrossovers(float proportion);
+    void updateCrossoverFrequencies(float proportion);
+    void updateLookaheadDelay();
+    
+    template<typename SampleType>
+    void splitBands(const juce::AudioBuffer<SampleType>& inputBuffer);
+    
+    template<typename SampleType>
+    void splitSidechain(const juce::AudioBuffer<SampleType>& sidechainBuffer);
+    
+    template<typename SampleType>
+    void splitBands(const juce::dsp::AudioBlock<const SampleType>& input,
+                    typename Pipeline<SampleType>::BandBlocks& bandBlocks,
+                    typename Pipeline<SampleType>::Crossover& iirCrossover,
+                    LinearPhaseCrossover<Params::NumBands>& linearCrossover);
     
-    void splitBands(const juce::AudioBuffer<float>& inputBuffer);
+    template<typename SampleType>
+    void sumBands(juce::AudioBuffer<SampleType>& buffer);
     
     juce::dsp::Oscillator<float> osc;
     juce::dsp::Gain<float>       gain;